@@ -29,6 +29,7 @@
 #define DCS_DES_ANALYZABLE_STATISTIC_ADAPTOR_HPP
 
 
+#include <cstddef>
 #include <dcs/des/base_analyzable_statistic.hpp>
 #include <dcs/type_traits/add_const.hpp>
 #include <dcs/type_traits/add_reference.hpp>
@@ -69,6 +70,15 @@ class analyzable_statistic_adaptor: public base_analyzable_statistic<
 	}
 
 
+    private: virtual void do_collect_block(value_type const* obs, value_type const* weights, ::std::size_t n)
+	{
+		for (::std::size_t i = 0; i < n; ++i)
+		{
+			adaptee_(obs[i], weights ? weights[i] : value_type(1));
+		}
+	}
+
+
     private: virtual void do_reset()
 	{
 		adaptee_.reset();
@@ -30,6 +30,7 @@
 
 
 #include <boost/smart_ptr.hpp>
+#include <cstddef>
 #include <dcs/des/analyzable_statistic_adaptor.hpp>
 #include <dcs/des/base_analyzable_statistic.hpp>
 #include <dcs/type_traits/add_const.hpp>
@@ -98,6 +99,16 @@ class any_analyzable_statistic
     }
 
 
+	/**
+	 * \brief Collect a block of \a n observations with the given weights (or
+	 *  with unit weights if \a weights is a null pointer).
+	 */
+	public: void collect(value_type const* obs, value_type const* weights, ::std::size_t n)
+	{
+		ptr_stat_->collect(obs, weights, n);
+	}
+
+
     public: void reset()
     {
         ptr_stat_->reset();
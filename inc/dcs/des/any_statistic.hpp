@@ -30,6 +30,7 @@
 
 
 #include <boost/smart_ptr.hpp>
+#include <cstddef>
 #include <dcs/des/base_statistic.hpp>
 #include <dcs/des/statistic_adaptor.hpp>
 #include <dcs/des/statistic_categories.hpp>
@@ -96,6 +97,16 @@ class any_statistic
 	}
 
 
+	/**
+	 * \brief Collect a block of \a n observations with the given weights (or
+	 *  with unit weights if \a weights is a null pointer).
+	 */
+	public: void collect(value_type const* obs, value_type const* weights, ::std::size_t n)
+	{
+		ptr_stat_->collect(obs, weights, n);
+	}
+
+
 	public: statistic_category category() const
 	{
 		return ptr_stat_->category();
@@ -41,6 +41,43 @@
 
 namespace dcs { namespace des {
 
+template <typename ValueT, typename UIntT>
+class base_analyzable_statistic;
+
+
+/**
+ * \brief Interface for objects to be notified when the state of an analyzable
+ *  statistic changes.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename ValueT, typename UIntT = std::size_t>
+class analyzable_statistic_listener
+{
+	public: typedef base_analyzable_statistic<ValueT,UIntT> statistic_type;
+
+
+	public: virtual ~analyzable_statistic_listener() { }
+
+	/**
+	 * \brief Called when the given statistic becomes satisfied (i.e., it
+	 *  reaches its target precision or it is disabled) or when it stops being
+	 *  satisfied.
+	 */
+	public: virtual void precision_state_changed(statistic_type& stat, bool satisfied) = 0;
+
+	/// Called when the given statistic enters or leaves its steady state.
+	public: virtual void steady_state_changed(statistic_type& stat, bool entered) = 0;
+
+	/**
+	 * \brief Called when the given statistic completes the collection of the
+	 *  observations of the current experiment (or it is disabled) or when it
+	 *  stops being complete.
+	 */
+	public: virtual void completion_state_changed(statistic_type& stat, bool satisfied) = 0;
+}; // analyzable_statistic_listener
+
+
 /**
  * \brief Base class for analyzable output statistics.
  *
@@ -51,6 +88,7 @@ class base_analyzable_statistic: public base_statistic<ValueT,UIntT>
 {
 	public: typedef ValueT value_type;
 	public: typedef UIntT uint_type;
+	public: typedef analyzable_statistic_listener<value_type,uint_type> listener_type;
 	private: typedef base_statistic<value_type,uint_type> base_type;
 
 
@@ -65,11 +103,37 @@ class base_analyzable_statistic: public base_statistic<ValueT,UIntT>
 //	}
 
 	protected: explicit base_analyzable_statistic(value_type relative_precision = default_target_relative_precision)
-	: target_rel_prec_(relative_precision)
+	: target_rel_prec_(relative_precision),
+	  ptr_listener_(0),
+	  satisfied_(false),
+	  steady_(false),
+	  complete_(false)
 	{
 	}
 
-	// Compiler-generated copy-constructor/assignment are fine.
+	/// Copy constructor: the listener is not copied.
+	protected: base_analyzable_statistic(base_analyzable_statistic const& that)
+	: base_type(that),
+	  target_rel_prec_(that.target_rel_prec_),
+	  ptr_listener_(0),
+	  satisfied_(that.satisfied_),
+	  steady_(that.steady_),
+	  complete_(that.complete_)
+	{
+	}
+
+	/// Copy assignment: the listener is left untouched.
+	protected: base_analyzable_statistic& operator=(base_analyzable_statistic const& rhs)
+	{
+		if (this != &rhs)
+		{
+			base_type::operator=(rhs);
+			target_rel_prec_ = rhs.target_rel_prec_;
+			notify_state_change();
+		}
+
+		return *this;
+	}
 
 	/// The destructor.
 	public: virtual ~base_analyzable_statistic() { }
@@ -88,6 +152,8 @@ class base_analyzable_statistic: public base_statistic<ValueT,UIntT>
 				   DCS_EXCEPTION_THROW(std::invalid_argument, "Relative precision must be a positive number"));
 
 		target_rel_prec_ = v;
+
+		notify_state_change();
 	}
 
 	/// Tells if the target precision has been reached.
@@ -156,16 +222,138 @@ class base_analyzable_statistic: public base_statistic<ValueT,UIntT>
 	public: void initialize_for_experiment()
 	{
 		do_initialize_for_experiment();
+
+		notify_state_change();
 	}
 
 	public: void finalize_for_experiment()
 	{
 		do_finalize_for_experiment();
+
+		notify_state_change();
 	}
 
 	public: void refresh()
 	{
 		do_refresh();
+
+		notify_state_change();
+	}
+
+	/**
+	 * \brief Tells if the state of this statistic may change as the simulated
+	 *  time advances, even when no observation is collected.
+	 *
+	 * Engines only call \c time_advanced on such statistics.
+	 */
+	public: bool time_dependent() const
+	{
+		return do_time_dependent();
+	}
+
+	/// Update the state of this statistic after the simulated time has advanced.
+	public: void time_advanced()
+	{
+		do_time_advanced();
+	}
+
+	/**
+	 * \brief Set the object to be notified when the state of this statistic
+	 *  changes.
+	 *
+	 * Only one listener at a time is supported; a null pointer removes the
+	 * current listener.
+	 * The cached state is brought up-to-date without notifying the listener.
+	 */
+	public: void listener(listener_type* ptr_listener)
+	{
+		ptr_listener_ = ptr_listener;
+		satisfied_ = !this->enabled() || target_precision_reached();
+		steady_ = steady_state_entered();
+		complete_ = !this->enabled() || observation_complete();
+	}
+
+	/// Returns the object to be notified when the state of this statistic changes.
+	public: listener_type* listener() const
+	{
+		return ptr_listener_;
+	}
+
+	/**
+	 * \brief Tells if this statistic does not prevent the simulation from
+	 *  ending, that is if it has reached the target precision or it has been
+	 *  disabled.
+	 *
+	 * The returned value is the one computed by the last state change.
+	 */
+	public: bool precision_satisfied() const
+	{
+		return satisfied_;
+	}
+
+	/**
+	 * \brief Tells if this statistic does not prevent the current experiment
+	 *  from ending, that is if it has collected the needed observations or it
+	 *  has been disabled.
+	 *
+	 * The returned value is the one computed by the last state change.
+	 */
+	public: bool completion_satisfied() const
+	{
+		return complete_;
+	}
+
+	/**
+	 * \brief Detect changes in the precision, steady state and completion of
+	 *  this statistic and notify the listener about them.
+	 *
+	 * Derived classes must call this method after every operation which may
+	 * change the relative precision or the steady state of the statistic.
+	 */
+	protected: void notify_state_change()
+	{
+		const bool satisfied(!this->enabled() || target_precision_reached());
+		const bool steady(steady_state_entered());
+
+		if (satisfied != satisfied_)
+		{
+			satisfied_ = satisfied;
+			if (ptr_listener_)
+			{
+				ptr_listener_->precision_state_changed(*this, satisfied);
+			}
+		}
+		if (steady != steady_)
+		{
+			steady_ = steady;
+			if (ptr_listener_)
+			{
+				ptr_listener_->steady_state_changed(*this, steady);
+			}
+		}
+
+		notify_completion_change();
+	}
+
+	/**
+	 * \brief Detect changes in the completion of this statistic and notify the
+	 *  listener about them.
+	 *
+	 * Unlike \c notify_state_change, the precision is not checked, so that
+	 * derived classes can call this method after each collected observation.
+	 */
+	protected: void notify_completion_change()
+	{
+		const bool complete(!this->enabled() || observation_complete());
+
+		if (complete != complete_)
+		{
+			complete_ = complete;
+			if (ptr_listener_)
+			{
+				ptr_listener_->completion_state_changed(*this, complete);
+			}
+		}
 	}
 
 	protected: virtual void do_initialize_for_experiment()
@@ -228,6 +416,12 @@ class base_analyzable_statistic: public base_statistic<ValueT,UIntT>
 	protected: virtual void do_refresh() {}
 
 
+	protected: virtual bool do_time_dependent() const { return false; }
+
+
+	protected: virtual void do_time_advanced() {}
+
+
 	protected: void do_enable(bool value)
 	{
 		base_type::do_enable(value);
@@ -250,6 +444,10 @@ class base_analyzable_statistic: public base_statistic<ValueT,UIntT>
 
 //	private: bool enabled_;
 	private: value_type target_rel_prec_; ///< The relative precision to be reached
+	private: listener_type* ptr_listener_; ///< The object notified on state changes
+	private: bool satisfied_; ///< Tells if precision was satisfied at the last state change
+	private: bool steady_; ///< Tells if steady state was entered at the last state change
+	private: bool complete_; ///< Tells if observations were complete at the last state change
 }; // base_analyzable_statistic
 
 
@@ -81,6 +81,32 @@ class base_statistic
 		do_collect(obs, weight);
 	}
 
+	/**
+	 * \brief Collect a block of observations.
+	 * \param obs The \a n observations.
+	 * \param weights The weights of the \a n observations, or a null pointer
+	 *  for unit weights.
+	 * \param n The number of observations.
+	 */
+	public: void collect(value_type const* obs, value_type const* weights, ::std::size_t n)
+	{
+		do_collect_block(obs, weights, n);
+	}
+
+	/**
+	 * \brief Collect a sequence of weighted observations.
+	 *
+	 * \tparam SampleRangeT The type of the sequence; it must provide the
+	 *  \c size(), \c observations() and \c weights() member functions, the
+	 *  latter two returning pointers to contiguous storage (e.g.,
+	 *  ::dcs::des::sample_range).
+	 */
+	public: template <typename SampleRangeT>
+		void collect(SampleRangeT const& samples)
+	{
+		do_collect_block(samples.observations(), samples.weights(), samples.size());
+	}
+
 	public: statistic_category category() const
 	{
 		return do_category();
@@ -138,9 +164,11 @@ class base_statistic
 
 	public: void enable(bool value)
 	{
-		do_enable(value);
-
+		// Set the flag first, so that derived classes see the new value
+		// (and can possibly change it) while handling the request
 		enabled_ = value;
+
+		do_enable(value);
 	}
 
 	/**
@@ -173,6 +201,15 @@ class base_statistic
 
 	private: virtual void do_collect(value_type obs, value_type weight) = 0;
 
+	/// Collect a block of observations (by default, one at a time).
+	private: virtual void do_collect_block(value_type const* obs, value_type const* weights, ::std::size_t n)
+	{
+		for (::std::size_t i = 0; i < n; ++i)
+		{
+			do_collect(obs[i], weights ? weights[i] : value_type(1));
+		}
+	}
+
 	private: virtual void do_reset() = 0;
 
 	private: virtual uint_type do_num_observations() const = 0;
@@ -29,17 +29,19 @@
 #define DCS_DES_BATCH_MEANS_ANALYZABLE_STATISTIC_HPP
 
 
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <cstdlib>
 #include <dcs/debug.hpp>
 #include <dcs/des/base_analyzable_statistic.hpp>
+#include <dcs/des/batch_means/dynamic_batch_means.hpp>
 #include <dcs/des/batch_means/pawlikowski1990_batch_size_detector.hpp>
+#include <dcs/des/detail/quantile_cache.hpp>
 #include <dcs/des/spectral/pawlikowski1990_transient_detector.hpp>
 #include <dcs/des/statistic_categories.hpp>
 #include <dcs/des/weighted_mean_estimator.hpp>
 #include <dcs/math/constants.hpp>
-#include <dcs/math/stats/distribution/students_t.hpp>
-#include <dcs/math/stats/function/quantile.hpp>
 #include <dcs/math/traits/float.hpp>
 #include <stdexcept>
 #include <vector>
@@ -102,6 +104,7 @@ class analyzable_statistic: public base_analyzable_statistic<
 	  trans_len_(0),
 	  batch_size_detected_(false),
 	  batch_size_(0),
+	  batch_means_(2*default_schmeiser_rule_batch_size),
 	  steady_start_time_(0)
 	{
 	}
@@ -141,15 +144,30 @@ class analyzable_statistic: public base_analyzable_statistic<
 	  trans_len_(0),
 	  batch_size_detected_(false),
 	  batch_size_(0),
+	  batch_means_(2*default_schmeiser_rule_batch_size),
 	  steady_start_time_(0)
 	{
 	}
 
 
+	/**
+	 * \brief Enable the additional precision test based on the
+	 *  recommendations found in (Schmeiser,1982).
+	 *
+	 * The batch means are also grouped into between \a schmeiser_rule_batch_size
+	 * and twice as many larger batches, by means of dynamic batch means (see
+	 * dynamic_batch_means), which are used as an alternative estimate of the
+	 * confidence interval.
+	 * Memory and time per batch are constant.
+	 */
 	public: void enable_schmeiser_rule(uint_type schmeiser_rule_batch_size=default_schmeiser_rule_batch_size)
 	{
 		use_schmeiser_rule_ = true;
 		k_b0_ = schmeiser_rule_batch_size;
+		if (k_b0_ > 0)
+		{
+			batch_means_ = dynamic_batch_means<value_type,uint_type>(2*k_b0_);
+		}
 	}
 
 
@@ -297,11 +315,12 @@ class analyzable_statistic: public base_analyzable_statistic<
 				// Transient phase just detected
 				// Put back steady-state observations possibly used for
 				// transient phase detection
-				typedef typename transient_phase_detector_type::sample_container vector_type;
-				typedef typename vector_type::const_iterator vector_iterator_type;
+				// Note: the observations are replayed from a view of the
+				// buffer of the transient detector, which is left untouched
+				// until it is reset.
+				typedef typename transient_phase_detector_type::sample_range_type sample_range_type;
 
-				vector_type obs = trans_detector_.steady_state_observations();
-				vector_iterator_type obs_end = obs.end();
+				sample_range_type obs = trans_detector_.steady_state_observations();
 
 				// Decrement counter since it is already been incremented
 				// during transient detection.
@@ -309,21 +328,16 @@ class analyzable_statistic: public base_analyzable_statistic<
 				// during transient detection.
 				count_ -= obs.size();
 
-				for (
-					vector_iterator_type it = obs.begin();
-					it != obs_end;
-					++it
-				) {
-					// Recursively call this method in order to collect
-					// observations for batch size detection or for
-					// sample accumulation
-					this->operator()(it->first, it->second);
-				}
+				// Recursively collect the observations for batch size
+				// detection or for sample accumulation
+				this->collect(obs);
 
 				DCS_DEBUG_TRACE("Safe steady-state observations put back."); 
 
 				// Reset transient detector to save memory
 				trans_detector_.reset();
+
+				this->notify_state_change();
 			}
 			else if (trans_detector_.aborted())
 			{
@@ -360,7 +374,9 @@ class analyzable_statistic: public base_analyzable_statistic<
 		batch_mean_.reset();
 		half_width_ = value_type(0);
 
-		batch_means_.clear();
+		batch_means_.reset();
+
+		this->notify_state_change();
 	}
 
 
@@ -467,10 +483,8 @@ class analyzable_statistic: public base_analyzable_statistic<
 
 		if (num_batches() > 1 && num_batches() >= min_num_batches_)
 		{
-			::dcs::math::stats::students_t_distribution<value_type> t_dist(num_batches()-1);
-
 			half_width_ = this->standard_deviation()
-						* ::dcs::math::stats::quantile(t_dist, (value_type(1)+this->confidence_level())/value_type(2));
+						* ::dcs::des::detail::students_t_quantile(num_batches()-1, (value_type(1)+this->confidence_level())/value_type(2));
 
 			// Compute the relative precision
 			// Note: the requirements that the estimate is different from zero
@@ -501,76 +515,86 @@ class analyzable_statistic: public base_analyzable_statistic<
 		}
 #endif // DCS_DEBUG
 
-		bool prec_reached = this->target_precision_reached();
-
 		/// This applies the recommendations found in (Schmeiser,1982)
-		if (!prec_reached
-			&& use_schmeiser_rule_
-			&& (k_b0_ > 0))
+		if (use_schmeiser_rule_
+			&& (k_b0_ > 0)
+			&& batch_means_(batch_mean)
+			&& !this->target_precision_reached()
+			&& batch_means_.num_batches() >= k_b0_
+			&& batch_means_.num_batches() > 1)
 		{
-			batch_means_.push_back(batch_mean);
-
-			if ((num_batches() % k_b0_) == 0)
+			// Additional test for precision by consolidating the k_be batch
+			// means into between k_b0 and 2*k_b0 means of longer batches
+			// (see (Schmeiser, 1982) and (Yeh,2000))
+
+			const uint_type k = batch_means_.num_batches();
+			const value_type grand_mean = batch_means_.mean();
+			const value_type grand_sd = ::std::sqrt(batch_means_.variance());
+
+			half_width_ = grand_sd
+						* ::dcs::des::detail::students_t_quantile(k-1, (value_type(1)+this->confidence_level())/value_type(2));
+			// Recompute precision and check again
+			if (grand_mean != 0)
 			{
-				// Additional test for precision by consolidating k_be 
-				// observations into k_b0 means of longer batches
-				// (see (Schmeiser, 1982)
+				rel_prec_ = half_width_ / ::std::abs(grand_mean); 
+			}
+			else
+			{
+				// In case of zero estimates, set the relative error to infinity
+				rel_prec_ = ::dcs::math::constants::infinity<value_type>::value;
+			}
 
-				uint_type k_be = num_batches();
-				uint_type m = k_be / k_b0_;
+#ifdef DCS_DEBUG
+			if (this->target_precision_reached())
+			{
+				DCS_DEBUG_TRACE("[Batch #" << num_batches() << "] Detected precision through Schmeiser trick: grand mean = " << grand_mean << " - reached precision = " << rel_prec_ << " - target precision: " << this->target_relative_precision()); 
+			}
+			else
+			{
+				DCS_DEBUG_TRACE("[Batch #" << num_batches() << "] Failed to detect precision through Schmeiser trick: grand mean = " << grand_mean << " - reached precision = " << rel_prec_ << " - target precision: " << this->target_relative_precision()); 
+			}
+#endif // DCS_DEBUG
+		}
 
-				value_type grand_mean = 0;
-				value_type grand_sd = 0;
+		this->notify_state_change();
+	}
 
-				uint_type i = 0;
-				for (uint_type j = 0; j < k_b0_; ++j)
-				{
-					value_type sum = 0;
-
-					for (uint_type r = 0; r < m; ++r)
-					{
-						//sum += obs_[j*m+r];
-						sum += batch_means_[i];
-						++i;
-					}
-
-					// Update the grand-mean and the grand-standard-deviation
-					value_type mean = sum/value_type(m);
-					value_type delta = mean - grand_mean;
-					grand_mean += delta/value_type(j+1);
-					grand_sd += delta*(mean-grand_mean);
-				}
-				if (k_b0_ > 1)
-				{
-					grand_sd = ::std::sqrt(grand_sd/value_type(k_b0_-1));
-
-					::dcs::math::stats::students_t_distribution<value_type> t_dist(k_b0_-1);
-					half_width_ = grand_sd
-								* ::dcs::math::stats::quantile(t_dist, (value_type(1)+this->confidence_level())/value_type(2));
-					// Recompute precision and check again
-					if (grand_mean != 0)
-					{
-						rel_prec_ = half_width_ / ::std::abs(grand_mean); 
-					}
-					else
-					{
-						// In case of zero estimates, set the relative error to infinity
-						rel_prec_ = ::dcs::math::constants::infinity<value_type>::value;
-					}
-				}
 
-				bool prec_reached = this->target_precision_reached();
-#ifdef DCS_DEBUG
-				if (prec_reached)
+	/**
+	 * \brief Collect a block of observations.
+	 *
+	 * Once the batch size is known, the observations which do not complete
+	 * the current batch are accumulated into the batch mean in a single
+	 * step; the other ones are collected one at a time.
+	 */
+	private: void do_collect_block(value_type const* obs, value_type const* weights, ::std::size_t n)
+	{
+		::std::size_t i(0);
+		while (i < n)
+		{
+			if (batch_size_detected_ && this->enabled())
+			{
+				// The observations that can be collected before the current
+				// batch is complete (or the maximum number of observations
+				// is reached)
+				::std::size_t m(batch_size_ - 1 - count_ % batch_size_);
+				if (max_num_obs_ != base_type::num_observations_infinity)
 				{
-					DCS_DEBUG_TRACE("[Batch #" << k_be << "] Detected precision through Schmeiser trick: grand mean = " << grand_mean << " - reached precision = " << rel_prec_ << " - target precision: " << this->target_relative_precision()); 
+					m = ::std::min(m, static_cast< ::std::size_t >(max_num_obs_ > count_+1 ? max_num_obs_-count_-1 : 0));
 				}
-				else
+				m = ::std::min(m, n-i);
+				if (m > 0)
 				{
-					DCS_DEBUG_TRACE("[Batch #" << k_be << "] Failed to detect precision through Schmeiser trick: grand mean = " << grand_mean << " - reached precision = " << rel_prec_ << " - target precision: " << this->target_relative_precision()); 
+					// Note: weights are ignored by the batch mean
+					batch_mean_.collect(obs+i, 0, m);
+					count_ += m;
+					i += m;
+					continue;
 				}
-#endif // DCS_DEBUG
 			}
+
+			do_collect(obs[i], weights ? weights[i] : value_type(1));
+			++i;
 		}
 	}
 
@@ -602,7 +626,9 @@ class analyzable_statistic: public base_analyzable_statistic<
 	private: uint_type batch_size_;
 	//private: value_type batch_mean_;
 	private: weighted_mean_estimator<value_type,uint_type> batch_mean_;
-	private: ::std::vector<value_type> batch_means_;
+	/// The batch means grouped into larger batches (used by the Schmeiser
+	/// rule).
+	private: dynamic_batch_means<value_type,uint_type> batch_means_;
 	private: value_type steady_start_time_;
 };
 
@@ -0,0 +1,233 @@
+/**
+ * \file dcs/des/batch_means/dynamic_batch_means.hpp
+ *
+ * \brief Batch means with a fixed number of batches whose size is doubled
+ *  when needed.
+ *
+ * Copyright (C) 2012       Distributed Computing System (DCS) Group,
+ *                          Computer Science Institute,
+ *                          Department of Science and Technological Innovation,
+ *                          University of Piemonte Orientale,
+ *                          Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_BATCH_MEANS_DYNAMIC_BATCH_MEANS_HPP
+#define DCS_DES_BATCH_MEANS_DYNAMIC_BATCH_MEANS_HPP
+
+
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/debug.hpp>
+#include <stdexcept>
+#include <vector>
+
+
+namespace dcs { namespace des { namespace batch_means {
+
+/**
+ * \brief Batch means with a fixed number of batches whose size is doubled
+ *  when needed.
+ *
+ * Values are grouped into consecutive batches of equal size, which are
+ * stored into a fixed number \f$2k\f$ of slots.
+ * When all the slots hold a complete batch, adjacent batches are pairwise
+ * merged, leaving \f$k\f$ complete batches of twice the size, and the
+ * following values are grouped according to the new batch size (see
+ * (Yeh,2000)).
+ *
+ * Hence, memory is constant and each value costs \f$O(1)\f$ amortized time;
+ * after the first \f$k\f$ batches are completed, the number of complete
+ * batches is always between \f$k\f$ and \f$2k-1\f$.
+ * The mean and the variance of the complete batch means are updated
+ * incrementally (and recomputed only when batches are merged).
+ *
+ * References:
+ * -# Y. Yeh and B.W. Schmeiser,
+ *    "Simulation output analysis via dynamic batch means",
+ *    Proc. of the 2000 Winter Simulation Conference, pp. 637-645, 2000.
+ * .
+ *
+ * \tparam RealT The type used for real numbers.
+ * \tparam UIntT The type used for unsigned integral numbers.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename RealT, typename UIntT=::std::size_t>
+class dynamic_batch_means
+{
+	public: typedef RealT real_type;
+	public: typedef UIntT uint_type;
+
+
+	/**
+	 * \brief A constructor.
+	 * \param num_slots The number of batch slots (must be even and greater
+	 *  than 0).
+	 */
+	public: explicit dynamic_batch_means(uint_type num_slots)
+	: means_(num_slots),
+	  num_batches_(0),
+	  batch_size_(1),
+	  partial_sum_(0),
+	  partial_count_(0),
+	  mean_(0),
+	  ss_(0)
+	{
+		// pre: num_slots > 0 && num_slots is even
+		DCS_ASSERT(
+			num_slots > 0 && (num_slots % 2) == 0,
+			throw ::std::invalid_argument("[dcs::des::batch_means::dynamic_batch_means::ctor] The number of slots must be even and greater than 0.")
+		);
+	}
+
+
+	/**
+	 * \brief Add a new value.
+	 * \return \c true if the value completes a batch; \c false otherwise.
+	 */
+	public: bool operator()(real_type value)
+	{
+		partial_sum_ += value;
+		++partial_count_;
+
+		if (partial_count_ < batch_size_)
+		{
+			return false;
+		}
+
+		// The current batch is complete
+		const real_type batch_mean(partial_sum_/real_type(batch_size_));
+		partial_sum_ = 0;
+		partial_count_ = 0;
+
+		means_[num_batches_] = batch_mean;
+		++num_batches_;
+
+		// Welford's update
+		const real_type delta(batch_mean-mean_);
+		mean_ += delta/real_type(num_batches_);
+		ss_ += delta*(batch_mean-mean_);
+
+		if (num_batches_ == means_.size())
+		{
+			merge();
+		}
+
+		return true;
+	}
+
+
+	/// Remove all the values (keeping the number of slots).
+	public: void reset()
+	{
+		num_batches_ = 0;
+		batch_size_ = 1;
+		partial_sum_ = partial_count_
+					 = 0;
+		mean_ = ss_
+			  = 0;
+	}
+
+
+	/// Return the number of complete batches.
+	public: uint_type num_batches() const
+	{
+		return num_batches_;
+	}
+
+
+	/// Return the number of values in each batch.
+	public: uint_type batch_size() const
+	{
+		return batch_size_;
+	}
+
+
+	/// Return the number of batch slots.
+	public: uint_type num_slots() const
+	{
+		return means_.size();
+	}
+
+
+	/// Return the mean of the \a i-th complete batch.
+	public: real_type batch_mean(uint_type i) const
+	{
+		// pre: i < num_batches()
+		DCS_DEBUG_ASSERT( i < num_batches_ );
+
+		return means_[i];
+	}
+
+
+	/// Return the mean of the complete batch means.
+	public: real_type mean() const
+	{
+		return mean_;
+	}
+
+
+	/// Return the sample variance of the complete batch means.
+	public: real_type variance() const
+	{
+		return num_batches_ > 1 ? ss_/real_type(num_batches_-1) : real_type(0);
+	}
+
+
+	/// Pairwise merge the batches and double the batch size.
+	private: void merge()
+	{
+		const uint_type n(means_.size()/2);
+
+		mean_ = ss_
+			  = 0;
+		for (uint_type i = 0; i < n; ++i)
+		{
+			const real_type batch_mean((means_[2*i]+means_[2*i+1])/real_type(2));
+			means_[i] = batch_mean;
+
+			const real_type delta(batch_mean-mean_);
+			mean_ += delta/real_type(i+1);
+			ss_ += delta*(batch_mean-mean_);
+		}
+		num_batches_ = n;
+		batch_size_ *= 2;
+	}
+
+
+	/// The means of the complete batches.
+	private: ::std::vector<real_type> means_;
+	/// The number of complete batches.
+	private: uint_type num_batches_;
+	/// The number of values in each batch.
+	private: uint_type batch_size_;
+	/// The sum of the values of the current (incomplete) batch.
+	private: real_type partial_sum_;
+	/// The number of values of the current (incomplete) batch.
+	private: uint_type partial_count_;
+	/// The mean of the complete batch means.
+	private: real_type mean_;
+	/// The sum of the squared deviations of the complete batch means from
+	/// their mean.
+	private: real_type ss_;
+};
+
+}}} // Namespace dcs::des::batch_means
+
+
+#endif // DCS_DES_BATCH_MEANS_DYNAMIC_BATCH_MEANS_HPP
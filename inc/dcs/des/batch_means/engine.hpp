@@ -38,6 +38,7 @@
 #include <dcs/des/batch_means/analyzable_statistic.hpp>
 #include <dcs/des/batch_means/dummy_batch_size_detector.hpp>
 #include <dcs/des/engine.hpp>
+#include <dcs/des/event_firing_hooks.hpp>
 #include <dcs/des/null_transient_detector.hpp>
 #include <dcs/des/output_analysis.hpp>
 #include <dcs/des/output_analysis_categories.hpp>
@@ -54,6 +55,8 @@ namespace batch_means {
  *
  * \tparam RealT The type used for real numbers.
  * \tparam UIntT The type used for positive integral numbers.
+ * \tparam FiringHooksT The policy for the BEFORE/AFTER-EVENT-FIRING events
+ *  (see \c with_event_firing_hooks and \c without_event_firing_hooks).
 // * \tparam TransientPhaseDetectorT The default transient phase detector type for
 // *  analyzable output statistics.
 // * \tparam BatchSizeDetectorT The default transient phase detector type for
@@ -74,7 +77,8 @@ namespace batch_means {
  */
 template <
 	typename RealT=double,
-	typename UIntT=::std::size_t
+	typename UIntT=::std::size_t,
+	typename FiringHooksT=with_event_firing_hooks
 >
 class engine: public ::dcs::des::engine<RealT>
 {
@@ -93,7 +97,7 @@ class engine: public ::dcs::des::engine<RealT>
 
 	protected: void prepare_simulation(engine_context_type& ctx)
 	{
-		base_type::prepare_simulation(ctx);
+		base_type::template prepare_simulation<FiringHooksT>(ctx);
 		this->initialize_simulated_system(ctx);
 	}
 
@@ -101,7 +105,19 @@ class engine: public ::dcs::des::engine<RealT>
 	protected: void finalize_simulation(engine_context_type& ctx)
 	{
 		this->finalize_simulated_system(ctx);
-		base_type::finalize_simulation(ctx);
+		base_type::template finalize_simulation<FiringHooksT>(ctx);
+	}
+
+
+	protected: void initialize_simulated_system(engine_context_type& ctx)
+	{
+		base_type::template initialize_simulated_system<FiringHooksT>(ctx);
+	}
+
+
+	protected: void finalize_simulated_system(engine_context_type& ctx)
+	{
+		base_type::template finalize_simulated_system<FiringHooksT>(ctx);
 	}
 
 
@@ -117,7 +133,7 @@ class engine: public ::dcs::des::engine<RealT>
 		{
 			DCS_DEBUG_TRACE( "Simulation time: " << this->simulated_time());
 
-			this->fire_next_event(ctx);
+			this->template fire_next_event<FiringHooksT>(ctx);
 
 			this->monitor_statistics();
 		}
@@ -209,7 +225,8 @@ template <
 	typename RealT,
 	typename UIntT,
 	typename TransientPhaseDetectorT,
-	typename BatchSizeDetectorT
+	typename BatchSizeDetectorT,
+	typename FiringHooksT
 >
 ::boost::shared_ptr<
 	typename make_analyzable_statistic_type<
@@ -225,7 +242,7 @@ template <
 //			BatchSizeDetectorT
 //		>
 	>::type
-> make_analyzable_statistic(StatisticT const& stat, TransientPhaseDetectorT const& transient_detector, BatchSizeDetectorT const& batch_size_detector, batch_means::engine<RealT,UIntT>& des_engine, RealT relative_precision, UIntT max_obs)
+> make_analyzable_statistic(StatisticT const& stat, TransientPhaseDetectorT const& transient_detector, BatchSizeDetectorT const& batch_size_detector, batch_means::engine<RealT,UIntT,FiringHooksT>& des_engine, RealT relative_precision, UIntT max_obs)
 {
 	typedef typename make_analyzable_statistic_type<
 						StatisticT,
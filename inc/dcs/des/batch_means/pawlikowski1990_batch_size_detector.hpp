@@ -32,16 +32,18 @@
 
 #include <boost/numeric/ublas/expression_types.hpp>
 #include <boost/numeric/ublas/traits.hpp>
+#include <boost/numeric/ublas/vector.hpp>
 #include <boost/numeric/ublas/vector_proxy.hpp>
 #include <boost/numeric/ublasx/operation/size.hpp>
 #include <cmath>
 #include <cstddef>
 #include <dcs/assert.hpp>
 #include <dcs/debug.hpp>
+#include <dcs/des/batch_means/dynamic_batch_means.hpp>
+#include <dcs/des/detail/quantile_cache.hpp>
 #include <dcs/des/weighted_mean_estimator.hpp>
 #include <dcs/math/constants.hpp>
 #include <dcs/math/function/sqr.hpp>
-#include <dcs/math/stats/distribution/normal.hpp>
 #include <stdexcept>
 #include <vector>
 
@@ -51,23 +53,24 @@ namespace dcs { namespace des { namespace batch_means {
 namespace detail { namespace /*<unnamed>*/ {
 
 /**
- * \brief Calculate an estimator of the autocovariance of lag \a k for the
- *  values in the vector \a x from \a n0 to \a n1 - 1.
+ * \brief Calculate the ordinary estimators of the autocorrelation coefficients
+ *  of lag 1 to \a L for the values in the vector \a x.
+ *
+ * The mean and the variance of \a x are computed only once for all the lags.
+ * On return, \a rho(k) holds the coefficient of lag \a k+1.
  */
-template <typename RealT, typename VectorT, typename UIntT>
-//static RealT autocovariance(VectorT const& x, UIntT k, UIntT n0, UIntT n1)
-static RealT autocovariance(::boost::numeric::ublas::vector_expression<VectorT> const& x, UIntT k)
+template <typename VectorT, typename UIntT, typename RealVectorT>
+static void autocorrelations(::boost::numeric::ublas::vector_expression<VectorT> const& x, UIntT L, RealVectorT& rho)
 {
 	namespace ublas = ::boost::numeric::ublas;
 	namespace ublasx = ::boost::numeric::ublasx;
 
-	typedef RealT real_type;
+	typedef typename ublas::vector_traits<RealVectorT>::value_type real_type;
 	typedef typename ublas::promote_traits<
 				UIntT,
 				typename ublas::vector_traits<VectorT>::size_type
 			>::promote_type size_type;
 
-	//size_type kb = (n1 - n0);
 	size_type kb = ublasx::size(x);
 
 	real_type sum = 0;
@@ -77,40 +80,43 @@ static RealT autocovariance(::boost::numeric::ublas::vector_expression<VectorT>
 	}
 	real_type mean = sum / real_type(kb);
 
+	// Autocovariance of lag 0
 	sum = 0;
-	for (size_type i = k; i < kb; ++i)
+	for (size_type i = 0; i < kb; ++i)
 	{
-		sum += (x()(i) - mean) * (x()(i-k) - mean);
+		sum += (x()(i) - mean) * (x()(i) - mean);
 	}
+	real_type var = sum / real_type(kb);
 
-	return sum / real_type(kb - k);
-}
-
+	for (size_type k = 1; k <= L; ++k)
+	{
+		// Autocovariance of lag k
+		sum = 0;
+		for (size_type i = k; i < kb; ++i)
+		{
+			sum += (x()(i) - mean) * (x()(i-k) - mean);
+		}
 
-/**
- * \brief Calculate ordinary estimator of autocorrelation
- *  coefficient of lag \a k for the values in the \a x.
- */
-template <typename RealT, typename VectorT, typename UIntT>
-//static RealT autocorrelation(VectorT const& v, UIntT k, UIntT n0, UIntT n1)
-static RealT autocorrelation(::boost::numeric::ublas::vector_expression<VectorT> const& x, UIntT k)
-{
-	//return autocovariance<RealT, UIntT, VectorT>(x, k, n0, n1) / autocovariance<RealT, UIntT, VectorT>(x, 0, n0, n1);
-	return autocovariance<RealT>(x, k) / autocovariance<RealT>(x, 0);
+		rho(k-1) = (sum / real_type(kb - k)) / var;
+	}
 }
 
 
 /**
- * \brief Calculate jacknife estimator of autocorrelation coefficient of lag
- *  \a k for the values in the vector \a x.
+ * \brief Calculate the jacknife estimators of the autocorrelation coefficients
+ *  of lag 1 to \a L for the values in the vector \a x.
+ *
+ * The ordinary estimators of all the lags are computed over the whole vector
+ * and over each of its two halves, and then combined.
+ * On return, \a r(k) holds the coefficient of lag \a k+1.
  */
-template <typename RealT, typename VectorT, typename UIntT>
-//static RealT autocorrelation_jacknife_estimator(VectorT const& x, UIntT k, UIntT N) 
-static RealT autocorrelation_jacknife_estimator(::boost::numeric::ublas::vector_expression<VectorT> const& x, UIntT k) 
+template <typename VectorT, typename UIntT, typename RealVectorT>
+static void autocorrelation_jacknife_estimators(::boost::numeric::ublas::vector_expression<VectorT> const& x, UIntT L, RealVectorT& r)
 {
 	namespace ublas = ::boost::numeric::ublas;
 	namespace ublasx = ::boost::numeric::ublasx;
 
+	typedef typename ublas::vector_traits<RealVectorT>::value_type real_type;
 	typedef typename ublas::promote_traits<
 				UIntT,
 				typename ublas::vector_traits<VectorT>::size_type
@@ -118,22 +124,18 @@ static RealT autocorrelation_jacknife_estimator(::boost::numeric::ublas::vector_
 
 	size_type N = ublasx::size(x);
 	size_type n = N / 2;
-	return RealT(2)
-			//* autocorrelation<RealT>(x, k, 0, N)
-			* autocorrelation<RealT>(x, k)
-			- (
-				//autocorrelation<RealT>(x, k, 0, n)
-				autocorrelation<RealT>(
-					ublas::subrange(x(), 0, n),
-					k
-				)
-				//+ autocorrelation<RealT>(x, k, n, N)
-				+ autocorrelation<RealT>(
-					ublas::subrange(x(), n, N),
-					k
-				)
-			  )
-			/ RealT(2);
+
+	ublas::vector<real_type> rho_lo(L);
+	ublas::vector<real_type> rho_hi(L);
+
+	autocorrelations(x, L, r);
+	autocorrelations(ublas::subrange(x(), 0, n), L, rho_lo);
+	autocorrelations(ublas::subrange(x(), n, N), L, rho_hi);
+
+	for (size_type k = 0; k < L; ++k)
+	{
+		r(k) = real_type(2) * r(k) - (rho_lo(k) + rho_hi(k)) / real_type(2);
+	}
 }
 
 }} // Namespace detail::<unnamed>
@@ -184,7 +186,7 @@ class pawlikowski1990_batch_size_detector
 	 * \brief A constructor.
 	 *
 	 * \param m0 Initial batch size. The final batch size chosen will be a
-	 *  multiple of this size.
+	 *  multiple of this size (precisely, \a m0 times a power of two).
 	 * \param k_b0 Length of the sequence of batch means tested for
 	 *  autocorrelation during the batch size selection phase.
 	 * \param beta Significance level below which autocorrelation between batch
@@ -195,19 +197,11 @@ class pawlikowski1990_batch_size_detector
 		  tot_num_obs_(0),
 		  m0_(m0),
 		  m_star_(m0),
-		  s_(1),
 		  acceptable_size_(false),
 		  k_b0_(k_b0),
 		  cur_anal_seq_len_(0),
 		  anal_seq_(k_b0),
-		  cur_ref_seq_len_(0),
-		  //ref_seq_len_incr_(10*k_b0),
-		  ref_seq_len_incr_(0.1*k_b0*m0),
-		  //ref_seq_(k_b0*m0),
-		  ref_seq_(k_b0),
-		  //ref_seq_(ref_seq_len_incr_),
-		  //ref_seq_sum_(0),
-		  //ref_seq_sum_sq_(0),
+		  ref_seq_(2*k_b0),
 		  //batch_mean_(0),
 		  batch_size_detected_(false),
 		  beta_(beta),
@@ -230,6 +224,14 @@ class pawlikowski1990_batch_size_detector
 	 * \param obs The new observation.
 	 * \return \c true if batch size is successfully detected; \c false
 	 *  otherwise.
+	 *
+	 * Batch means of size \c m0 are appended to the "Reference Sequence",
+	 * which holds at most \f$2k_{b_0}\f$ batch means and pairwise merges them
+	 * when full (see dynamic_batch_means).
+	 * Each time it holds exactly \f$k_{b_0}\f$ batch means (i.e., once for
+	 * each candidate batch size \f$2^j m_0\f$), these are tested for
+	 * autocorrelation.
+	 * Thus, memory does not depend on the number of observations.
 	 */
 	public: bool detect(real_type obs, real_type weight)
 	{
@@ -243,148 +245,76 @@ class pawlikowski1990_batch_size_detector
 			}
 
 #ifdef DCS_DEBUG
-//			++tot_num_obs_;
 			// Don't print too many times ;)
 			if ((tot_num_obs_ % 1000) == 0)
 			{
-				DCS_DEBUG_TRACE("Batch size determination is in progress (total observation #" << tot_num_obs_ << " / batch observation #: " << (batch_num_obs_+1) << "). Next check at " << (s_*m0_*k_b0_));
+				DCS_DEBUG_TRACE("Batch size determination is in progress (total observation #" << tot_num_obs_ << " / batch observation #: " << (batch_num_obs_+1) << "). Trying with batch size: " << (ref_seq_.batch_size()*m0_));
 			}
 #endif // DCS_DEBUG
 
 			++tot_num_obs_;
 
-			//batch_mean_ += obs;
 			batch_mean_(obs, weight);
 			++batch_num_obs_;
 
-			//DCS_DEBUG_TRACE("Batch Detection - Observation["<<batch_num_obs_<<"/"<<tot_num_obs_<<"]: " << obs << " ---> SUM: " << batch_mean_ );//XXX
+			if (batch_num_obs_ < m0_)
+			{
+				return false;
+			}
+
+			// Append the batch mean to the Reference Sequence
+			const bool complete = ref_seq_(batch_mean_.estimate());
 
-//FIXME: these are two alternatives; the first (true part) collect at most
-// m0_*k_b0_ observations into the Reference Sequence. The second one (false
-// part) allows the Reference Sequence to indefinitively grow.
-// At the moment we prefer the first one since avoid memory exhaustion.
-#if true
-			if (batch_num_obs_ <= m0_*k_b0_)
+			// Reset the state of this batch
+			batch_mean_.reset();
+			batch_num_obs_ = 0;
+
+			if (!complete || ref_seq_.num_batches() != k_b0_)
 			{
-				if ((batch_num_obs_ % m0_) == 0)
-				{
-//					// Check if there is enough room in the Reference Sequence.
-//					if (cur_ref_seq_len_ == ref_seq_.size())
-//					{
-//						ref_seq_.resize(ref_seq_.size() + ref_seq_len_incr_);
-//					}
-
-					// Compute batch mean and append to the Reference Sequence..
-					////batch_mean_ /= real_type(batch_num_obs_);
-					//batch_mean_ /= real_type(m0_);
-					if (cur_ref_seq_len_ == ref_seq_.size())
-					{
-						ref_seq_.resize(ref_seq_.size()+k_b0_, true);
-					}
-					//ref_seq_(cur_ref_seq_len_) = batch_mean_;
-					ref_seq_(cur_ref_seq_len_) = batch_mean_.estimate();
-					++cur_ref_seq_len_;
-
-					//DCS_DEBUG_TRACE("Batch[#" << cur_ref_seq_len_ << "]: size = " << m_star_ << ", observations: " << batch_num_obs_ << ", mean = " << batch_mean_);
-
-					//ref_seq_sum_ += batch_mean_;
-					//ref_seq_sum_sq_ += detail::sqr(batch_mean);
-					// Reset the state of this batch
-					//batch_mean_ = 0;
-					batch_mean_.reset();
-				}
+				return false;
 			}
-			else
+
+			// Test the consolidated batches for autocorrelation.
+
+			const uint_type m = ref_seq_.batch_size()*m0_;
+
+			DCS_DEBUG_TRACE("Batch size determination is in progress. Testing batch size: " << m);
+
+			consolidate_batches();
+
+			bool ok = false;
+			if (uncorrelated())
 			{
-				// Consolidate batches and test them for autocorrelation.
-
-				DCS_DEBUG_TRACE("Batch size determination is in progress. Trying with batch size: " << (s_*m0_));
-
-				batch_num_obs_ = 0;
-
-//				for (uint_type i=0;i<cur_ref_seq_len_;++i)//XXX
-//				{//XXX
-//					DCS_DEBUG_TRACE("Before Consolidation -- REF_SEQ[" << i << "]: " <<ref_seq_(i));//XXX
-//				}//XXX
-//				for (uint_type i=0;i<cur_anal_seq_len_;++i)//XXX
-//				{//XXX
-//					DCS_DEBUG_TRACE("Before Consolidation -- ANAL_SEQ[" << i << "]: " <<anal_seq_(i));//XXX
-//				}//XXX
-
-				consolidate_batches();
-
-//				for (uint_type i=0;i<cur_ref_seq_len_;++i)//XXX
-//				{//XXX
-//					DCS_DEBUG_TRACE("After Consolidation -- REF_SEQ[" << i << "]: " <<ref_seq_(i));//XXX
-//				}//XXX
-//				for (uint_type i=0;i<cur_anal_seq_len_;++i)//XXX
-//				{//XXX
-//					DCS_DEBUG_TRACE("After Consolidation -- ANAL_SEQ[" << i << "]: " <<anal_seq_(i));//XXX
-//				}//XXX
-
-				bool ok = false;
-				if (uncorrelated())
-				{
-					if (acceptable_size_)
-					{
-						/// Batches are uncorrelated for two consecutive times
-						/// So assume this size is good.
-						//accept_batch_size();
-
-						ok = true;
-					}
-					else
-					{
-						// Autocorrelations for the current batch size are negligible but
-						// they were not for the previous batch size.
-						// Thus the next batch size should be considered.
-
-						DCS_DEBUG_TRACE("Batch size: " << s_*m0_ << " acceptable... but need more checking.");
-
-						acceptable_size_ = true;
-					}
-				}
-				else
+				if (acceptable_size_)
 				{
-					DCS_DEBUG_TRACE("Batch size: " << s_*m0_ << " rejected.");
-				}
+					/// Batches are uncorrelated for two consecutive times
+					/// So assume this size is good.
 
-				if (ok)
-				{
-					DCS_DEBUG_TRACE("Batch size: " << s_*m0_ << " accepted.");
-
-					//batch_mean_ = 0;
-					batch_mean_.reset();
-					m_star_ = s_*m0_;
-					batch_size_detected_ = true;
-					//ref_seq_.clear();
-
-					// Copy the analyzed batch means into the Reference Sequence
-					// for later use.
-					ref_seq_.resize(cur_anal_seq_len_);
-					::std::copy(
-						anal_seq_.begin(),
-						anal_seq_.begin() + cur_anal_seq_len_,
-						ref_seq_.begin()
-					);
-					cur_ref_seq_len_ = cur_anal_seq_len_;
+					ok = true;
 				}
 				else
 				{
-					// Re-initialize the counter variable for the next autocorrelation test
-					++s_;
+					// Autocorrelations for the current batch size are negligible but
+					// they were not for the previous batch size.
+					// Thus the next batch size should be considered.
+
+					DCS_DEBUG_TRACE("Batch size: " << m << " acceptable... but need more checking.");
+
+					acceptable_size_ = true;
 				}
 			}
-#else // true
-			//if (batch_num_obs_ >= m0_)
-			//if ((batch_num_obs_ % m0_) == 0)
-			if (batch_num_obs_ == m_star_)
+			else
+			{
+				DCS_DEBUG_TRACE("Batch size: " << m << " rejected.");
+			}
+
+			if (ok)
 			{
-				// Collected the needed number of observations to form a batch.
-				// Going to process this new batch.
-				process_batch_mean();
+				DCS_DEBUG_TRACE("Batch size: " << m << " accepted.");
+
+				m_star_ = m;
+				batch_size_detected_ = true;
 			}
-#endif // true
 		}
 
 		return batch_size_detected_;
@@ -419,43 +349,23 @@ class pawlikowski1990_batch_size_detector
 	public: void reset()
 	{
 		batch_num_obs_ = cur_anal_seq_len_
-					   = cur_ref_seq_len_
 					   = uint_type(0);
 
-		s_ = uint_type(1);
-
-//#ifdef DCS_DEBUG
 		tot_num_obs_ = uint_type(0);
-//#endif // DCS_DEBUG
 
 		m_star_ = m0_;
 
-		//batch_mean_ = real_type(0);
 		batch_mean_.reset();
 
 		acceptable_size_ = batch_size_detected_
 						 = detect_aborted_
 						 = false;
 
-		//anal_seq_.resize(k_b0_);
 		anal_seq_.clear();
-		//ref_seq_.resize(ref_seq_len_incr_, false);
-		ref_seq_.resize(k_b0_*m0_, false);
-		ref_seq_.clear();
+		ref_seq_.reset();
 	}
 
 
-//	//[XXX]: deprecated by estimated_size
-//	/// \deprecated by estimated_size
-//	/// \todo Decide what to do when this method is called and acceptable_size_
-//	///  is \c false.
-//	public: uint_type estimated_batch_size() const
-//	{
-//		return m_star_;
-//	}
-//	//[/XXX]
-
-
 	/// \todo Decide what to do when this method is called and acceptable_size_
 	///  is \c false.
 	public: uint_type estimated_size() const
@@ -464,113 +374,26 @@ class pawlikowski1990_batch_size_detector
 	}
 
 
-//	//[XXX]: deprecated by computed_means
-//	/// \deprecated by computed_estimators
-//	public: vector_type const& batch_means() const
-//	{
-//		return ref_seq_;
-//	}
-//	//[/XXX]
-
-
-	public: vector_type computed_estimators() const
-	{
-		return vector_type(ref_seq_.begin(), ref_seq_.end());
-	}
-
-
 	/**
-	 * \brief Append current batch mean to the Reference Sequence and test for
-	 *  autocorrelation with already collected batch means.
+	 * \brief Return the batch means (of size estimated_size()) tested for
+	 *  autocorrelation when the batch size has been accepted.
 	 */
-	private: void process_batch_mean()
+	public: vector_type computed_estimators() const
 	{
-		// Check if there is enough room in the Reference Sequence.
-		if (cur_ref_seq_len_ == ref_seq_.size())
-		{
-			ref_seq_.resize(ref_seq_.size() + ref_seq_len_incr_);
-		}
-
-		// Compute batch mean and append to the Reference Sequence..
-		//batch_mean_ /= real_type(batch_num_obs_);
-		//ref_seq_(cur_ref_seq_len_) = batch_mean_;
-		ref_seq_(cur_ref_seq_len_) = batch_mean_.reset();
-		++cur_ref_seq_len_;
-
-		//DCS_DEBUG_TRACE("Batch[#" << cur_ref_seq_len_ << "]: size = " << m_star_ << ", observations: " << batch_num_obs_ << ", mean = " << batch_mean_);
-
-		//ref_seq_sum_ += batch_mean_;
-		//ref_seq_sum_sq_ += detail::sqr(batch_mean);
-		// Reset the state of this batch
-		//batch_mean_ = 0;
-		batch_mean_.reset();
-		batch_num_obs_ = 0;
-		if (cur_ref_seq_len_ == (s_ * k_b0_))
-		{
-			// Consolidate batches and test them for autocorrelation.
-
-			DCS_DEBUG_TRACE("Batch size determination is in progress. Trying with batch size: " << (s_*m0_));
-
-			test_for_correlation();
-		}
-	}
-
-
-	/*
-	 *   Consolidate batches and test them for autocorrelation.
-	 */
-	private: void test_for_correlation()
-	{
-		consolidate_batches();
-
-		if (uncorrelated())
-		{
-			if (acceptable_size_)
-			{
-				/// Batches are uncorrelated for two consecutive times
-				/// So assume this size is good.
-				accept_batch_size();
-
-				DCS_DEBUG_TRACE("Batch size: " << s_*m0_ << " accepted.");
-
-				return;
-			}
-
-			// Autocorrelations for the current batch size are negligible but
-			// they were not for the previous batch size.
-			// Thus the next batch size should be considered.
-	
-			DCS_DEBUG_TRACE("Batch size: " << s_*m0_ << " acceptable... but need more checking.");
-
-			acceptable_size_ = true;
-		}
-
-		DCS_DEBUG_TRACE("Batch size: " << s_*m0_ << " rejected.");
-
-		// Re-initialize the counter variable for the next autocorrelation test
-		++s_;
+		return vector_type(anal_seq_.begin(), anal_seq_.begin() + cur_anal_seq_len_);
 	}
 
 
 	/**
-	 * \brief Consolidate groups of \c s_ batch means from the "Reference
-	 *  Sequence" into the "Analyzed Sequence" (which will be tested for
-	 *  autocorrelation).
+	 * \brief Copy the batch means of the "Reference Sequence" into the
+	 *  "Analyzed Sequence" (which will be tested for autocorrelation).
 	 */
 	private: void consolidate_batches()
 	{
 		cur_anal_seq_len_ = 0;
-		uint_type i = 0;
 		while (cur_anal_seq_len_ < k_b0_)
 		{
-			real_type sum = 0;
-			for (uint_type j = 0; j < s_; ++j)
-			{
-				//sum += ref_seq_(cur_anal_seq_len_*s_+j);
-				sum += ref_seq_(i);
-				++i;
-			}
-			anal_seq_(cur_anal_seq_len_) = sum / real_type(s_);
+			anal_seq_(cur_anal_seq_len_) = ref_seq_.batch_mean(cur_anal_seq_len_);
 			++cur_anal_seq_len_;
 		}
 	}
@@ -599,23 +422,18 @@ class pawlikowski1990_batch_size_detector
 		real_type z;
 		internal_vector_type r(L);
 
-		::dcs::math::stats::normal_distribution<real_type> n01_dist;
-		z = n01_dist.quantile(real_type(1)-beta_k/real_type(2));
+		z = ::dcs::des::detail::normal_quantile(real_type(1)-beta_k/real_type(2));
 
-		for (uint_type k = 0; k < L; ++k)
-		{
-			// compute the jacknife estimator of the autocorrelation coefficient
-			// at lag k
-//			r(k) = detail::autocorrelation_jacknife_estimator<real_type, uint_type, internal_vector_type>(
-//				anal_seq_,
-//				k,
-//				k_b0
-//			);
-			r(k) = detail::autocorrelation_jacknife_estimator<real_type>(
+		// compute the jacknife estimators of the autocorrelation coefficients
+		// at lags 1 to L
+		detail::autocorrelation_jacknife_estimators(
 				::boost::numeric::ublas::subrange(anal_seq_, 0, k_b0),
-				k+1
+				L,
+				r
 			);
-		}
+
+		// Running sum of the squared coefficients of the lower lags
+		real_type sum = 0;
 		for (uint_type k = 0; k < L; ++k)
 		{
 			real_type sigma_sq;
@@ -626,14 +444,7 @@ class pawlikowski1990_batch_size_detector
 			}
 			else
 			{
-				real_type sum = 0;
-				//uint_type u_end = k-1;
-				////for (uint_type u = 1; u < k; ++u)
-				//for (uint_type u = 0; u < u_end; ++u)
-				for (uint_type u = 0; u < k; ++u)
-				{
-					sum += ::dcs::math::sqr(r(u));
-				}
+				sum += ::dcs::math::sqr(r(k-1));
 
 				sigma_sq = (real_type(1) + real_type(2) * sum) / real_type(k_b0);
 			}
@@ -660,117 +471,15 @@ class pawlikowski1990_batch_size_detector
 	}
 
 
-//	/**
-//	 * \brief Calculate jacknife estimator of autocorrelation
-//	 *  coefficient of lag k for the values in the anal_seq_.
-//	 */
-//	private: real_type jacknife_estimator(uint_type k) const
-//	{
-//		uint_type N = cur_anal_seq_len_;
-//		uint_type n = N / 2;
-//		//return real_type(2) * autocorrelation(k, 0, N) - (autocorrelation(k, 0, n) + autocorrelation(k, n, N))/real_type(2);
-//		return real_type(2) * detail::autocorrelation(anal_seq_, k, 0, N) - (detail::autocorrelation(anal_seq_, k, 0, n) + detail::autocorrelation(anal_seq_, k, n, N))/real_type(2);
-//	}
-
-
-//	/**
-//	 * \brief Calculate ordinary estimator of autocorrelation
-//	 *  coefficient of lag k for the values in the anal_seq_
-//	 *  from n0 to n1-1.
-//	 */
-//	private: real_type autocorrelation(uint_type k, uint_type n0, uint_type n1)
-//	{
-//		//return autocovariance(k, n0, n1) / autocovariance(0, n0, n1);
-//		return detail::autocovariance<real_type, uint_type, internal_vector_type>(anal_seq_, k, n0, n1) / detail::autocovariance<real_type, uint_type, internal_vector_type>(anal_seq_, 0, n0, n1);
-//	}
-
-
-//	/**
-//	 * \brief Calculate an estimator of the autocovariance of
-//	 *  lag k for the values in the anal_seq_ from n0 to n1-1.
-//	 */
-//	private: real_type autocovariance(uint_type k, uint_type n0, uint_type n1)
-//	{
-//		uint_type kb = (n1 - n0);
-//		::dcs::math::la::vector_range<internal_vector_type> x(::dcs::math::la::subrange(anal_seq_, n0, anal_seq_.size()));
-//
-//		real_type sum = 0;
-//		for (uint_type i = 0; i < kb; ++i)
-//		{
-//			sum += x(i);
-//		}
-//		real_type mean = sum / real_type(kb);
-//
-//		sum = 0;
-//		for (uint_type i = k; i < kb; ++i)
-//		{
-//			sum += (x(i) - mean) * (x(i-k) - mean);
-//		}
-//
-//		return sum / real_type(kb - k);
-//	}
-
-
-	/*
-	 * \brief Change the batch size being accumulated in the "Reference
-	 *  Sequence" to the one currently being used for the "Analyzed Sequence",
-	 *  and consolidate the batches in the "Reference Sequence" accordingly.
-	 *
-	 * At the end of this function, if the batch size m_star has been selected,
-	 * then the "Reference Sequence" contains s_*k_b0_ batch means of size
-	 * m_star/s_ and the "Analyzed Sequence" contains k_b0_ batch means of size
-	 * m_star_.
-	 */
-	private: void accept_batch_size()
-	{
-		m_star_ *= s_; // ==> m_star = s_*m0
-		batch_size_detected_ = true;
-
-		DCS_DEBUG_TRACE("Batch Size " << m_star_ << ", " << tot_num_obs_);
-
-//		for (uint_type i = 0; i < cur_anal_seq_len_; ++i)
-//		{
-//			ref_seq_(i) = anal_seq_(i);
-//		}
-		::std::copy(
-			anal_seq_.begin(),
-			anal_seq_.begin() + cur_anal_seq_len_,
-			ref_seq_.begin()
-		);
-		cur_ref_seq_len_ = cur_anal_seq_len_;
-		//ref_seq_sum_ /= s_;
-		//ref_seq_sum_sq_ = sum_squares(ref_seq_, cur_ref_seq_len_);
-	}
-
-
-//	/**
-//	 * \brief Calculate sum of squares of given sequence.
-//	 */
-//	private: real_type sum_squares(internal_vector_type const& x, uint_type n)
-//	{
-//		real_type sum_sq = 0;
-//		for (uint_type i = 0; i < n; ++i)
-//		{
-//			sum_sq += ::dcs::math::sqr(x(i));
-//		}
-//		return sum_sq;
-//	}
-
-
 	/// Number of observation inside a single batch.
 	private: uint_type batch_num_obs_;
-//#ifdef DCS_DEBUG
 	/// Total number of collected observations.
 	private: uint_type tot_num_obs_;
-//#endif //DCS_DEBUG
 	/// Initial size of the batch. The final batch size will be a multiple of
 	/// this size.
 	private: /*const*/ uint_type m0_;
 	/// Estimated size of the current batch.
 	private: uint_type m_star_;
-	/// The "sequential step": number of entries of the "Reference Sequence"
-	/// consolidated into each entry of the "Analyzed Sequence".
-	private: uint_type s_;
 	/// Tell if an acceptable batch size has been reached.
 	private: bool acceptable_size_;
 	/// Maximum number of batch means stored in the "Analyzed Sequence".
@@ -779,20 +488,10 @@ class pawlikowski1990_batch_size_detector
 	private: uint_type cur_anal_seq_len_;
 	/// The "Analized Sequence": holds batch means to be analyzed
 	private: internal_vector_type anal_seq_;
-	///// Maximum length of the "Reference Sequence".
-	//private: uint_type; max_ref_seq_len_;
-	/// Current number of batch means inserted into the "Reference Sequence".
-	private: uint_type cur_ref_seq_len_;
-	/// Amount by which increment the size of the "Reference Sequence".
-	private: /*const*/ uint_type ref_seq_len_incr_;
-	/// The "Reference Sequence": holds batch means
-	private: internal_vector_type ref_seq_;
-	///// Sum of the collected observations.
-	//private: real_type ref_seq_sum_;
-	///// Sum of the collected observations.
-	//private: real_type ref_seq_sum_sq_;
+	/// The "Reference Sequence": holds (at most 2*k_b0) means of batches
+	/// whose size is m0 times a power of two.
+	private: dynamic_batch_means<real_type,uint_type> ref_seq_;
 	/// Batch mean of the collected observations.
-	//private: real_type batch_mean_;
 	private: weighted_mean_estimator<real_type,uint_type> batch_mean_;
 	/// Tells if batch size is still to be detected
 	private: bool batch_size_detected_;
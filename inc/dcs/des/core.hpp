@@ -45,6 +45,7 @@
 #include <dcs/des/output_analysis_categories.hpp>
 #include <dcs/des/output_analysis.hpp>
 #include <dcs/des/quantile_estimator.hpp>
+#include <dcs/des/sample_range.hpp>
 #include <dcs/des/statistic_adaptor.hpp>
 #include <dcs/des/statistic_categories.hpp>
 #include <dcs/des/utility.hpp>
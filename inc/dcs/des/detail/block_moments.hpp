@@ -0,0 +1,197 @@
+/**
+ * \file dcs/des/detail/block_moments.hpp
+ *
+ * \brief Mean and sum of squared deviations of blocks of observations.
+ *
+ * Copyright (C) 2012       Distributed Computing System (DCS) Group,
+ *                          Computer Science Institute,
+ *                          Department of Science and Technological Innovation,
+ *                          University of Piemonte Orientale,
+ *                          Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_DETAIL_BLOCK_MOMENTS_HPP
+#define DCS_DES_DETAIL_BLOCK_MOMENTS_HPP
+
+
+#include <cstddef>
+
+
+namespace dcs { namespace des { namespace detail {
+
+/**
+ * \brief Compute the mean and the sum of squared deviations from the mean of
+ *  the block of \a n observations \a x.
+ *
+ * The corrected two-pass algorithm is used (see (Chan,1983)): the first pass
+ * computes the mean, the second one the squared deviations and their sum,
+ * which compensates for the rounding error of the mean.
+ * Both passes use four independent accumulators, so that consecutive
+ * iterations do not depend on each other and the loops can be pipelined or
+ * vectorized by the compiler.
+ *
+ * References:
+ * -# T.F. Chan, G.H. Golub and R.J. LeVeque,
+ *    "Algorithms for computing the sample variance: analysis and
+ *    recommendations",
+ *    The American Statistician, 37(3):242-247, 1983.
+ * .
+ */
+template <typename RealT>
+void block_moments(RealT const* x, ::std::size_t n, RealT& mean, RealT& m2)
+{
+	mean = m2
+		 = RealT(0);
+
+	if (n == 0)
+	{
+		return;
+	}
+
+	const ::std::size_t n4(n - n%4);
+
+	RealT s0(0), s1(0), s2(0), s3(0);
+	for (::std::size_t i = 0; i < n4; i += 4)
+	{
+		s0 += x[i];
+		s1 += x[i+1];
+		s2 += x[i+2];
+		s3 += x[i+3];
+	}
+	for (::std::size_t i = n4; i < n; ++i)
+	{
+		s0 += x[i];
+	}
+	mean = ((s0+s1)+(s2+s3))/RealT(n);
+
+	RealT d0(0), d1(0), d2(0), d3(0);
+	RealT q0(0), q1(0), q2(0), q3(0);
+	for (::std::size_t i = 0; i < n4; i += 4)
+	{
+		const RealT e0(x[i]-mean);
+		const RealT e1(x[i+1]-mean);
+		const RealT e2(x[i+2]-mean);
+		const RealT e3(x[i+3]-mean);
+		d0 += e0; q0 += e0*e0;
+		d1 += e1; q1 += e1*e1;
+		d2 += e2; q2 += e2*e2;
+		d3 += e3; q3 += e3*e3;
+	}
+	for (::std::size_t i = n4; i < n; ++i)
+	{
+		const RealT e(x[i]-mean);
+		d0 += e;
+		q0 += e*e;
+	}
+	const RealT d((d0+d1)+(d2+d3));
+	m2 = ((q0+q1)+(q2+q3)) - d*d/RealT(n);
+	if (m2 < 0)
+	{
+		m2 = 0;
+	}
+}
+
+
+/**
+ * \brief Compute the total weight, the weighted mean and the weighted sum of
+ *  squared deviations from the mean of the block of \a n observations \a x
+ *  with weights \a w.
+ *
+ * Same as block_moments, but for weighted observations.
+ */
+template <typename RealT>
+void weighted_block_moments(RealT const* x, RealT const* w, ::std::size_t n, RealT& sumw, RealT& mean, RealT& m2)
+{
+	sumw = mean
+		 = m2
+		 = RealT(0);
+
+	if (n == 0)
+	{
+		return;
+	}
+
+	const ::std::size_t n4(n - n%4);
+
+	RealT w0(0), w1(0), w2(0), w3(0);
+	RealT s0(0), s1(0), s2(0), s3(0);
+	for (::std::size_t i = 0; i < n4; i += 4)
+	{
+		w0 += w[i];   s0 += w[i]*x[i];
+		w1 += w[i+1]; s1 += w[i+1]*x[i+1];
+		w2 += w[i+2]; s2 += w[i+2]*x[i+2];
+		w3 += w[i+3]; s3 += w[i+3]*x[i+3];
+	}
+	for (::std::size_t i = n4; i < n; ++i)
+	{
+		w0 += w[i];
+		s0 += w[i]*x[i];
+	}
+	sumw = (w0+w1)+(w2+w3);
+	mean = ((s0+s1)+(s2+s3))/sumw;
+
+	RealT d0(0), d1(0), d2(0), d3(0);
+	RealT q0(0), q1(0), q2(0), q3(0);
+	for (::std::size_t i = 0; i < n4; i += 4)
+	{
+		const RealT e0(x[i]-mean);
+		const RealT e1(x[i+1]-mean);
+		const RealT e2(x[i+2]-mean);
+		const RealT e3(x[i+3]-mean);
+		d0 += w[i]*e0;   q0 += w[i]*e0*e0;
+		d1 += w[i+1]*e1; q1 += w[i+1]*e1*e1;
+		d2 += w[i+2]*e2; q2 += w[i+2]*e2*e2;
+		d3 += w[i+3]*e3; q3 += w[i+3]*e3*e3;
+	}
+	for (::std::size_t i = n4; i < n; ++i)
+	{
+		const RealT e(x[i]-mean);
+		d0 += w[i]*e;
+		q0 += w[i]*e*e;
+	}
+	const RealT d((d0+d1)+(d2+d3));
+	m2 = ((q0+q1)+(q2+q3)) - d*d/sumw;
+	if (m2 < 0)
+	{
+		m2 = 0;
+	}
+}
+
+
+/**
+ * \brief Merge the moments of a block of observations with total weight
+ *  \a wb, mean \a mb and sum of squared deviations \a m2b into the moments
+ *  \a wa, \a ma and \a m2a of another one (see (Chan,1983)).
+ *
+ * For unweighted observations, the weights are the numbers of observations.
+ */
+template <typename RealT>
+void merge_moments(RealT& wa, RealT& ma, RealT& m2a, RealT wb, RealT mb, RealT m2b)
+{
+	const RealT w(wa+wb);
+	const RealT delta(mb-ma);
+
+	ma += delta*(wb/w);
+	m2a += m2b + delta*delta*(wa*wb/w);
+	wa = w;
+}
+
+}}} // Namespace dcs::des::detail
+
+
+#endif // DCS_DES_DETAIL_BLOCK_MOMENTS_HPP
@@ -0,0 +1,454 @@
+/**
+ * \file dcs/des/detail/event_sink_list.hpp
+ *
+ * \brief Flat list of event sinks with delegate-based dispatch.
+ *
+ * Copyright (C) 2012       Distributed Computing System (DCS) Group,
+ *                          Computer Science Institute,
+ *                          Department of Science and Technological Innovation,
+ *                          University of Piemonte Orientale,
+ *                          Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_DETAIL_EVENT_SINK_LIST_HPP
+#define DCS_DES_DETAIL_EVENT_SINK_LIST_HPP
+
+
+#include <boost/function.hpp>
+#include <boost/function_equal.hpp>
+#include <boost/smart_ptr.hpp>
+#include <cstddef>
+#include <dcs/debug.hpp>
+#include <utility>
+#include <vector>
+
+
+namespace dcs { namespace des { namespace detail {
+
+/// Unique tag identifying the type \c F of an event sink.
+template <typename F>
+struct event_sink_tag
+{
+	static const char value;
+};
+
+template <typename F>
+const char event_sink_tag<F>::value = 0;
+
+
+/**
+ * \brief Flat list of event sinks with delegate-based dispatch.
+ *
+ * Each event sink is stored as a delegate, that is a pair made of a pointer
+ * to a (heap-allocated) copy of the callable object and a pointer to a
+ * function invoking it.
+ * Emitting an event is a loop over a contiguous array of delegates, with no
+ * locking and no memory allocation.
+ *
+ * Sinks may be connected and disconnected while an event is being emitted:
+ * sinks disconnected during the emission are not invoked anymore, while sinks
+ * connected during the emission are only invoked from the next emission on.
+ *
+ * \note This class is not thread-safe.
+ *
+ * \tparam EventT The event type.
+ * \tparam EngineContextT The engine context type.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename EventT, typename EngineContextT>
+class event_sink_list
+{
+	public: typedef EventT event_type;
+	public: typedef EngineContextT engine_context_type;
+	public: typedef unsigned long sink_id_type;
+	public: typedef ::boost::function<void (event_type const&, engine_context_type&)> function_type;
+	private: typedef void (*invoker_type)(void*, event_type const&, engine_context_type&);
+	private: typedef void (*deleter_type)(void*);
+	private: struct delegate
+	{
+		/// The function invoking the callable object (null if disconnected).
+		invoker_type invoke;
+		/// The pointer to the callable object.
+		void* ptr_fn;
+		/// The function destroying the callable object.
+		deleter_type destroy;
+		/// The tag identifying the type of the callable object.
+		void const* tag;
+		/// The sink identifier.
+		sink_id_type id;
+	};
+	private: typedef ::std::vector<delegate> delegate_container;
+
+
+	public: event_sink_list()
+	: next_id_(0),
+	  num_sinks_(0),
+	  emit_depth_(0),
+	  num_dead_(0)
+	{
+		// empty
+	}
+
+
+	private: event_sink_list(event_sink_list const&);
+
+
+	private: event_sink_list& operator=(event_sink_list const&);
+
+
+	public: ~event_sink_list()
+	{
+		typename delegate_container::iterator end_it(delegates_.end());
+		for (typename delegate_container::iterator it = delegates_.begin(); it != end_it; ++it)
+		{
+			if (it->invoke)
+			{
+				it->destroy(it->ptr_fn);
+			}
+		}
+	}
+
+
+	/// Add a copy of the callable object \a f as event sink.
+	public: template <typename F>
+		sink_id_type connect(F const& f)
+	{
+		delegate d;
+		d.invoke = &invoke_impl<F>;
+		d.ptr_fn = new F(f);
+		d.destroy = &destroy_impl<F>;
+		d.tag = &event_sink_tag<F>::value;
+		d.id = next_id_++;
+
+		delegates_.push_back(d);
+		++num_sinks_;
+
+		return d.id;
+	}
+
+
+	/**
+	 * \brief Remove all the event sinks equal to the callable object \a f.
+	 *
+	 * A sink matches if it has been connected either as a callable object of
+	 * the same type as \a f or as a \c function_type wrapping such an object,
+	 * and if it compares equal to \a f (through \c boost::function_equal).
+	 * Like for Boost.Signals2, sinks cannot be disconnected through a
+	 * \c function_type object, since \c boost::function objects are not
+	 * comparable; use connection identifiers instead.
+	 *
+	 * \return \c true if at least one sink has been removed.
+	 */
+	public: template <typename F>
+		bool disconnect(F const& f)
+	{
+		bool found(false);
+
+		const ::std::size_t n(delegates_.size());
+		for (::std::size_t i = 0; i < n; ++i)
+		{
+			delegate& d(delegates_[i]);
+
+			if (d.invoke && same_sink(d, f))
+			{
+				kill(d);
+				found = true;
+			}
+		}
+
+		compact();
+
+		return found;
+	}
+
+
+	/// Remove the event sink with the given identifier.
+	public: void disconnect_id(sink_id_type id)
+	{
+		const ::std::size_t n(delegates_.size());
+		for (::std::size_t i = 0; i < n; ++i)
+		{
+			if (delegates_[i].invoke && delegates_[i].id == id)
+			{
+				kill(delegates_[i]);
+				break;
+			}
+		}
+
+		compact();
+	}
+
+
+	/// Tell if the event sink with the given identifier is connected.
+	public: bool connected(sink_id_type id) const
+	{
+		const ::std::size_t n(delegates_.size());
+		for (::std::size_t i = 0; i < n; ++i)
+		{
+			if (delegates_[i].invoke && delegates_[i].id == id)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+
+	/// Remove all the event sinks.
+	public: void disconnect_all()
+	{
+		const ::std::size_t n(delegates_.size());
+		for (::std::size_t i = 0; i < n; ++i)
+		{
+			if (delegates_[i].invoke)
+			{
+				kill(delegates_[i]);
+			}
+		}
+
+		compact();
+	}
+
+
+	/// Invoke all the event sinks (in connection order).
+	public: void emit(event_type const& evt, engine_context_type& ctx)
+	{
+		// Sinks connected during the emission are not invoked
+		const ::std::size_t n(delegates_.size());
+
+		{
+			// Restore the nesting level even if some sink throws
+			emit_depth_guard guard(emit_depth_);
+
+			for (::std::size_t i = 0; i < n; ++i)
+			{
+				// Note: don't hold references to delegates, since the container
+				//       may grow while invoking the sink
+				if (delegates_[i].invoke)
+				{
+					delegates_[i].invoke(delegates_[i].ptr_fn, evt, ctx);
+				}
+			}
+		}
+
+		compact();
+	}
+
+
+	/// Tell if there is no event sink.
+	public: bool empty() const
+	{
+		return num_sinks_ == 0;
+	}
+
+
+	/// Return the number of event sinks.
+	public: ::std::size_t size() const
+	{
+		return num_sinks_;
+	}
+
+
+	/// Tell if the given delegate holds a callable object equal to \a f.
+	private: template <typename F>
+		static bool same_sink(delegate const& d, F const& f)
+	{
+		// Note: call function_equal unqualified to let ADL find the overloads
+		//       for binders (e.g., the one in boost/bind.hpp)
+		using ::boost::function_equal;
+
+		if (d.tag == &event_sink_tag<F>::value)
+		{
+			return function_equal(*static_cast<F const*>(d.ptr_fn), f);
+		}
+		if (d.tag == &event_sink_tag<function_type>::value)
+		{
+			F const* ptr_target(static_cast<function_type const*>(d.ptr_fn)->template target<F>());
+
+			return ptr_target && function_equal(*ptr_target, f);
+		}
+
+		return false;
+	}
+
+
+	private: template <typename F>
+		static void invoke_impl(void* ptr_fn, event_type const& evt, engine_context_type& ctx)
+	{
+		(*static_cast<F*>(ptr_fn))(evt, ctx);
+	}
+
+
+	private: template <typename F>
+		static void destroy_impl(void* ptr_fn)
+	{
+		delete static_cast<F*>(ptr_fn);
+	}
+
+
+	/// Disconnect the given delegate (its slot is reclaimed later).
+	private: void kill(delegate& d)
+	{
+		if (emit_depth_ > 0)
+		{
+			// The callable object may be currently running: postpone its
+			// destruction
+			dead_fns_.push_back(::std::make_pair(d.destroy, d.ptr_fn));
+		}
+		else
+		{
+			d.destroy(d.ptr_fn);
+		}
+		d.invoke = 0;
+		d.ptr_fn = 0;
+		--num_sinks_;
+		++num_dead_;
+	}
+
+
+	/// Remove disconnected delegates, if not emitting.
+	private: void compact()
+	{
+		if (emit_depth_ > 0)
+		{
+			return;
+		}
+
+		typename ::std::vector< ::std::pair<deleter_type,void*> >::iterator fn_end_it(dead_fns_.end());
+		for (typename ::std::vector< ::std::pair<deleter_type,void*> >::iterator it = dead_fns_.begin(); it != fn_end_it; ++it)
+		{
+			it->first(it->second);
+		}
+		dead_fns_.clear();
+
+		if (num_dead_ == 0)
+		{
+			return;
+		}
+
+		::std::size_t j(0);
+		const ::std::size_t n(delegates_.size());
+		for (::std::size_t i = 0; i < n; ++i)
+		{
+			if (delegates_[i].invoke)
+			{
+				delegates_[j++] = delegates_[i];
+			}
+		}
+		delegates_.resize(j);
+		num_dead_ = 0;
+	}
+
+
+	/// Increment the nesting level of emissions for the lifetime of the guard.
+	private: class emit_depth_guard
+	{
+		public: explicit emit_depth_guard(::std::size_t& depth)
+		: depth_(depth)
+		{
+			++depth_;
+		}
+
+		public: ~emit_depth_guard()
+		{
+			--depth_;
+		}
+
+		private: emit_depth_guard(emit_depth_guard const&);
+
+		private: emit_depth_guard& operator=(emit_depth_guard const&);
+
+		private: ::std::size_t& depth_;
+	};
+
+
+	/// The delegates.
+	private: delegate_container delegates_;
+	/// The callable objects disconnected during an emission.
+	private: ::std::vector< ::std::pair<deleter_type,void*> > dead_fns_;
+	/// The next sink identifier.
+	private: sink_id_type next_id_;
+	/// The number of connected sinks.
+	private: ::std::size_t num_sinks_;
+	/// The nesting level of emissions.
+	private: ::std::size_t emit_depth_;
+	/// The number of disconnected delegates still in the container.
+	private: ::std::size_t num_dead_;
+};
+
+
+/**
+ * \brief Connection between an event source and an event sink, when the
+ *  delegate-based dispatch is used.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename EventT, typename EngineContextT>
+class event_sink_connection
+{
+	private: typedef event_sink_list<EventT,EngineContextT> sink_list_type;
+	public: typedef typename sink_list_type::sink_id_type sink_id_type;
+
+
+	public: event_sink_connection()
+	: wptr_sinks_(),
+	  id_(0)
+	{
+		// empty
+	}
+
+
+	public: event_sink_connection(::boost::shared_ptr<sink_list_type> const& ptr_sinks, sink_id_type id)
+	: wptr_sinks_(ptr_sinks),
+	  id_(id)
+	{
+		// empty
+	}
+
+
+	/// Disconnect the event sink from the event source.
+	public: void disconnect() const
+	{
+		::boost::shared_ptr<sink_list_type> ptr_sinks(wptr_sinks_.lock());
+
+		if (ptr_sinks)
+		{
+			ptr_sinks->disconnect_id(id_);
+		}
+	}
+
+
+	/// Tell if the event sink is still connected to the event source.
+	public: bool connected() const
+	{
+		::boost::shared_ptr<sink_list_type> ptr_sinks(wptr_sinks_.lock());
+
+		return ptr_sinks && ptr_sinks->connected(id_);
+	}
+
+
+	private: ::boost::weak_ptr<sink_list_type> wptr_sinks_;
+	private: sink_id_type id_;
+};
+
+}}} // Namespace dcs::des::detail
+
+
+#endif // DCS_DES_DETAIL_EVENT_SINK_LIST_HPP
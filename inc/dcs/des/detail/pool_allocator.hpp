@@ -0,0 +1,339 @@
+/**
+ * \file dcs/des/detail/pool_allocator.hpp
+ *
+ * \brief Free-list allocator for objects of (mostly) fixed size.
+ *
+ * Copyright (C) 2012       Distributed Computing System (DCS) Group,
+ *                          Computer Science Institute,
+ *                          Department of Science and Technological Innovation,
+ *                          University of Piemonte Orientale,
+ *                          Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_DETAIL_POOL_ALLOCATOR_HPP
+#define DCS_DES_DETAIL_POOL_ALLOCATOR_HPP
+
+
+#include <boost/smart_ptr.hpp>
+#include <cstddef>
+#include <dcs/debug.hpp>
+#include <limits>
+#include <new>
+#include <vector>
+
+
+namespace dcs { namespace des { namespace detail {
+
+/**
+ * \brief Arena of fixed-size memory blocks managed through a free-list.
+ *
+ * The size of the blocks is fixed by the first allocation request; requests
+ * of a different size are forwarded to the global \c operator \c new.
+ * Blocks are carved out of chunks of increasing size, and freed blocks are
+ * kept in a free-list for later reuse.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+class fixed_size_pool
+{
+	private: union block
+	{
+		block* next;
+		// Force the maximum alignment
+		long double ld;
+		void* p;
+		void (*pf)();
+	};
+
+
+	private: static const ::std::size_t min_chunk_blocks = 64;
+	private: static const ::std::size_t max_chunk_blocks = 65536;
+
+
+	public: fixed_size_pool()
+	: block_size_(0),
+	  chunk_blocks_(min_chunk_blocks),
+	  ptr_free_(0),
+	  num_live_(0)
+	{
+		// empty
+	}
+
+
+	private: fixed_size_pool(fixed_size_pool const&);
+
+
+	private: fixed_size_pool& operator=(fixed_size_pool const&);
+
+
+	public: ~fixed_size_pool()
+	{
+		// check: all blocks should have been given back
+		DCS_DEBUG_ASSERT( num_live_ == 0 );
+
+		free_chunks();
+	}
+
+
+	/// Allocate a memory block of \a n bytes.
+	public: void* allocate(::std::size_t n)
+	{
+		if (block_size_ == 0)
+		{
+			block_size_ = round_up(n);
+		}
+
+		if (round_up(n) != block_size_)
+		{
+			return ::operator new(n);
+		}
+
+		if (!ptr_free_)
+		{
+			grow();
+		}
+
+		block* ptr_blk(ptr_free_);
+		ptr_free_ = ptr_blk->next;
+		++num_live_;
+
+		return ptr_blk;
+	}
+
+
+	/// Give back the memory block \a p of \a n bytes.
+	public: void deallocate(void* p, ::std::size_t n)
+	{
+		if (round_up(n) != block_size_)
+		{
+			::operator delete(p);
+			return;
+		}
+
+		block* ptr_blk(static_cast<block*>(p));
+		ptr_blk->next = ptr_free_;
+		ptr_free_ = ptr_blk;
+		--num_live_;
+	}
+
+
+	/**
+	 * \brief Release all the memory at once, if no block is still in use.
+	 * \return \c true if the memory has been released; \c false otherwise.
+	 */
+	public: bool release()
+	{
+		if (num_live_ > 0)
+		{
+			return false;
+		}
+
+		free_chunks();
+
+		return true;
+	}
+
+
+	/// Return the number of blocks currently in use.
+	public: ::std::size_t num_live_blocks() const
+	{
+		return num_live_;
+	}
+
+
+	private: static ::std::size_t round_up(::std::size_t n)
+	{
+		return ((n+sizeof(block)-1)/sizeof(block))*sizeof(block);
+	}
+
+
+	/// Allocate a new chunk and thread its blocks into the free-list.
+	private: void grow()
+	{
+		const ::std::size_t nb(block_size_/sizeof(block));
+
+		block* ptr_chunk(static_cast<block*>(::operator new(chunk_blocks_*block_size_)));
+		chunks_.push_back(ptr_chunk);
+
+		for (::std::size_t i = chunk_blocks_; i > 0; --i)
+		{
+			block* ptr_blk(ptr_chunk+(i-1)*nb);
+			ptr_blk->next = ptr_free_;
+			ptr_free_ = ptr_blk;
+		}
+
+		if (chunk_blocks_ < max_chunk_blocks)
+		{
+			chunk_blocks_ *= 2;
+		}
+	}
+
+
+	private: void free_chunks()
+	{
+		::std::vector<block*>::const_iterator end_it(chunks_.end());
+		for (::std::vector<block*>::const_iterator it = chunks_.begin(); it != end_it; ++it)
+		{
+			::operator delete(*it);
+		}
+		chunks_.clear();
+		ptr_free_ = 0;
+		chunk_blocks_ = min_chunk_blocks;
+	}
+
+
+	/// The size of each block (in bytes).
+	private: ::std::size_t block_size_;
+	/// The number of blocks of the next chunk.
+	private: ::std::size_t chunk_blocks_;
+	/// The head of the free-list.
+	private: block* ptr_free_;
+	/// The number of blocks currently in use.
+	private: ::std::size_t num_live_;
+	/// The allocated chunks.
+	private: ::std::vector<block*> chunks_;
+};
+
+
+/**
+ * \brief Standard-conforming allocator drawing single objects from a shared
+ *  \c fixed_size_pool.
+ *
+ * Copies of the allocator (including rebound ones) share the same pool, which
+ * is kept alive until the last copy is destroyed.
+ * This makes it suitable for \c boost::allocate_shared, where a copy of the
+ * allocator is stored inside each control block.
+ *
+ * \tparam T The type of the allocated objects.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename T>
+class pool_allocator
+{
+	template <typename U> friend class pool_allocator;
+
+	public: typedef T value_type;
+	public: typedef T* pointer;
+	public: typedef T const* const_pointer;
+	public: typedef T& reference;
+	public: typedef T const& const_reference;
+	public: typedef ::std::size_t size_type;
+	public: typedef ::std::ptrdiff_t difference_type;
+	public: typedef ::boost::shared_ptr<fixed_size_pool> pool_pointer;
+
+
+	public: template <typename U>
+		struct rebind
+	{
+		typedef pool_allocator<U> other;
+	};
+
+
+	public: explicit pool_allocator(pool_pointer const& ptr_pool)
+	: ptr_pool_(ptr_pool)
+	{
+		// empty
+	}
+
+
+	public: template <typename U>
+		pool_allocator(pool_allocator<U> const& that)
+	: ptr_pool_(that.ptr_pool_)
+	{
+		// empty
+	}
+
+
+	public: pointer address(reference x) const
+	{
+		return &x;
+	}
+
+
+	public: const_pointer address(const_reference x) const
+	{
+		return &x;
+	}
+
+
+	public: pointer allocate(size_type n, void const* hint = 0)
+	{
+		(void)hint;
+
+		if (n == 1)
+		{
+			return static_cast<pointer>(ptr_pool_->allocate(sizeof(T)));
+		}
+
+		return static_cast<pointer>(::operator new(n*sizeof(T)));
+	}
+
+
+	public: void deallocate(pointer p, size_type n)
+	{
+		if (n == 1)
+		{
+			ptr_pool_->deallocate(p, sizeof(T));
+		}
+		else
+		{
+			::operator delete(p);
+		}
+	}
+
+
+	public: size_type max_size() const
+	{
+		return ::std::numeric_limits<size_type>::max()/sizeof(T);
+	}
+
+
+	public: void construct(pointer p, const_reference x)
+	{
+		new (p) T(x);
+	}
+
+
+	public: void destroy(pointer p)
+	{
+		p->~T();
+	}
+
+
+	public: template <typename U>
+		bool operator==(pool_allocator<U> const& rhs) const
+	{
+		return ptr_pool_ == rhs.ptr_pool_;
+	}
+
+
+	public: template <typename U>
+		bool operator!=(pool_allocator<U> const& rhs) const
+	{
+		return ptr_pool_ != rhs.ptr_pool_;
+	}
+
+
+	private: pool_pointer ptr_pool_;
+};
+
+}}} // Namespace dcs::des::detail
+
+
+#endif // DCS_DES_DETAIL_POOL_ALLOCATOR_HPP
@@ -0,0 +1,336 @@
+/**
+ * \file dcs/des/detail/quantile_cache.hpp
+ *
+ * \brief Cached quantiles of the Student's t and standard Normal
+ *  distributions.
+ *
+ * Copyright (C) 2012       Distributed Computing System (DCS) Group,
+ *                          Computer Science Institute,
+ *                          Department of Science and Technological Innovation,
+ *                          University of Piemonte Orientale,
+ *                          Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_DETAIL_QUANTILE_CACHE_HPP
+#define DCS_DES_DETAIL_QUANTILE_CACHE_HPP
+
+
+#include <boost/math/special_functions/fpclassify.hpp>
+#include <cmath>
+#include <cstddef>
+#include <dcs/debug.hpp>
+#include <dcs/math/stats/distribution/normal.hpp>
+#include <dcs/math/stats/distribution/students_t.hpp>
+#include <limits>
+#include <vector>
+
+
+namespace dcs { namespace des { namespace detail {
+
+/**
+ * \brief Cache of the quantiles of the Student's t and standard Normal
+ *  distributions.
+ *
+ * Quantiles are keyed by the probability \f$p\f$ (e.g., \f$(1+\ell)/2\f$ for
+ * a two-sided confidence interval at level \f$\ell\f$) and by the degrees of
+ * freedom \f$\nu\f$.
+ * For \f$\nu \le\f$ \c max_exact_dof, quantiles are computed exactly (by
+ * inverting the distribution function) the first time they are requested,
+ * and then stored.
+ * For larger values of \f$\nu\f$, the Cornish-Fisher expansion of the
+ * Student's t quantile in terms of the Normal quantile \f$z_p\f$ is used
+ * (see (Abramowitz,1964), formula 26.7.5):
+ * \f[
+ *  t_{p,\nu} \approx z_p + \frac{g_1(z_p)}{\nu} + \frac{g_2(z_p)}{\nu^2}
+ *                  + \frac{g_3(z_p)}{\nu^3} + \frac{g_4(z_p)}{\nu^4}
+ * \f]
+ * whose error is \f$O(\nu^{-5})\f$, that is well below the double precision
+ * for \f$\nu > 1000\f$.
+ *
+ * Since only few probabilities are used in practice (usually, one for each
+ * confidence level), they are kept in a small array which is linearly
+ * searched, starting from the last one used.
+ *
+ * References:
+ * -# M. Abramowitz and I.A. Stegun,
+ *    "Handbook of Mathematical Functions",
+ *    National Bureau of Standards, 1964.
+ * .
+ *
+ * \note This class is not thread-safe.
+ *
+ * \tparam RealT The type used for real numbers.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename RealT>
+class quantile_cache
+{
+	public: typedef RealT real_type;
+	public: typedef ::std::size_t size_type;
+	private: struct entry
+	{
+		/// The probability.
+		real_type p;
+		/// The standard Normal quantile.
+		real_type z;
+		/// The coefficients of the Cornish-Fisher expansion.
+		real_type g[4];
+		/// The exact Student's t quantiles (NaN if not yet computed).
+		::std::vector<real_type> t;
+	};
+
+
+	/// Maximum number of degrees of freedom for which exact quantiles are used.
+	public: static const size_type max_exact_dof = 1000;
+
+
+	public: quantile_cache()
+	: last_(0)
+	{
+		// empty
+	}
+
+
+	/// Return the \a p-th quantile of the standard Normal distribution.
+	public: real_type normal_quantile(real_type p)
+	{
+		return lookup(p).z;
+	}
+
+
+	/**
+	 * \brief Return the \a p-th quantile of the Student's t distribution with
+	 *  \a dof degrees of freedom.
+	 */
+	public: real_type students_t_quantile(size_type dof, real_type p)
+	{
+		// pre: dof > 0
+		DCS_DEBUG_ASSERT( dof > 0 );
+
+		entry& e(lookup(p));
+
+		if (dof > max_exact_dof)
+		{
+			const real_type nu(dof);
+
+			return e.z + (e.g[0] + (e.g[1] + (e.g[2] + e.g[3]/nu)/nu)/nu)/nu;
+		}
+
+		if (e.t.size() <= dof)
+		{
+			e.t.resize(dof+1, ::std::numeric_limits<real_type>::quiet_NaN());
+		}
+		if (::boost::math::isnan(e.t[dof]))
+		{
+			::dcs::math::stats::students_t_distribution<real_type> dist(dof);
+			e.t[dof] = dist.quantile(p);
+		}
+
+		return e.t[dof];
+	}
+
+
+	/// Remove all the cached quantiles.
+	public: void clear()
+	{
+		entries_.clear();
+		last_ = 0;
+	}
+
+
+	/// Return the entry associated to the probability \a p (creating it if needed).
+	private: entry& lookup(real_type p)
+	{
+		if (last_ < entries_.size() && entries_[last_].p == p)
+		{
+			return entries_[last_];
+		}
+
+		const size_type n(entries_.size());
+		for (size_type i = 0; i < n; ++i)
+		{
+			if (entries_[i].p == p)
+			{
+				last_ = i;
+				return entries_[i];
+			}
+		}
+
+		entry e;
+		::dcs::math::stats::normal_distribution<real_type> dist;
+		const real_type z(dist.quantile(p));
+		const real_type z2(z*z);
+		e.p = p;
+		e.z = z;
+		e.g[0] = z*(z2+1)/real_type(4);
+		e.g[1] = z*((real_type(5)*z2+real_type(16))*z2+real_type(3))/real_type(96);
+		e.g[2] = z*(((real_type(3)*z2+real_type(19))*z2+real_type(17))*z2-real_type(15))/real_type(384);
+		e.g[3] = z*((((real_type(79)*z2+real_type(776))*z2+real_type(1482))*z2-real_type(1920))*z2-real_type(945))/real_type(92160);
+
+		entries_.push_back(e);
+		last_ = n;
+
+		return entries_.back();
+	}
+
+
+	/// The cached quantiles, one entry for each probability.
+	private: ::std::vector<entry> entries_;
+	/// The index of the last used entry.
+	private: size_type last_;
+};
+
+template <typename RealT>
+const typename quantile_cache<RealT>::size_type quantile_cache<RealT>::max_exact_dof;
+
+
+/**
+ * \brief Return the quantile cache shared by all the estimators.
+ *
+ * \note The shared cache is a function-local static object which is updated
+ *  on lookup without any synchronization; thus it (and all the functions
+ *  using it) must only be used from a single thread at a time.
+ *  Multi-threaded code should use a \c quantile_cache instance per thread.
+ */
+template <typename RealT>
+inline
+quantile_cache<RealT>& shared_quantile_cache()
+{
+	static quantile_cache<RealT> cache;
+
+	return cache;
+}
+
+
+/// Return the \a p-th quantile of the standard Normal distribution.
+template <typename RealT>
+inline
+RealT normal_quantile(RealT p)
+{
+	return shared_quantile_cache<RealT>().normal_quantile(p);
+}
+
+
+/**
+ * \brief Return the \a p-th quantile of the Student's t distribution with
+ *  \a dof degrees of freedom.
+ */
+template <typename RealT>
+inline
+RealT students_t_quantile(::std::size_t dof, RealT p)
+{
+	return shared_quantile_cache<RealT>().students_t_quantile(dof, p);
+}
+
+
+/// Tell if \f$n \ge (t_{p,n-1} c)^2\f$ (or if the right-hand side is \c NaN).
+template <typename RealT, typename UIntT>
+inline
+bool students_t_sample_size_ok(quantile_cache<RealT>& cache, RealT c, RealT p, UIntT n)
+{
+	const RealT tc(cache.students_t_quantile(n-1, p)*c);
+
+	return !(static_cast<RealT>(n) < tc*tc);
+}
+
+
+/**
+ * \brief Find the smallest sample size \f$n\f$ in \f$[lo,hi)\f$ such that
+ *  \f$n \ge (t_{p,n-1} c)^2\f$.
+ *
+ * \param c The ratio between the standard deviation and the wanted
+ *  half-width of the confidence interval.
+ * \param p The probability of the Student's t quantile.
+ * \param lo The minimum sample size (must be greater than 1).
+ * \param hi The maximum sample size.
+ * \return The smallest sample size in \f$[lo,hi)\f$ satisfying the condition,
+ *  or \a hi if no such sample size exists.
+ *
+ * Since \f$t_{p,n-1}\f$ decreases with \f$n\f$, the condition is monotone in
+ * \f$n\f$ and the search is performed by first doubling the step until the
+ * condition holds and then bisecting the last interval.
+ * Moreover, since \f$t_{p,n-1} > z_p\f$, the search starts from the
+ * closed-form lower bound \f$\lceil (z_p c)^2 \rceil\f$.
+ * A \c NaN value of the right-hand side is taken as satisfying the condition.
+ */
+template <typename RealT, typename UIntT>
+UIntT students_t_sample_size(RealT c, RealT p, UIntT lo, UIntT hi)
+{
+	// pre: lo > 1
+	DCS_DEBUG_ASSERT( lo > 1 );
+
+	if (lo >= hi)
+	{
+		return hi;
+	}
+
+	quantile_cache<RealT>& cache(shared_quantile_cache<RealT>());
+
+	// Closed-form lower bound
+	const RealT z(cache.normal_quantile(p));
+	const RealT n_z(::std::ceil((z*c)*(z*c)));
+	if (n_z >= static_cast<RealT>(hi))
+	{
+		lo = hi-1;
+	}
+	else if (n_z > static_cast<RealT>(lo))
+	{
+		lo = static_cast<UIntT>(n_z);
+	}
+
+	if (students_t_sample_size_ok(cache, c, p, lo))
+	{
+		return lo;
+	}
+
+	// Invariant: the condition does not hold for 'lo'
+
+	// Exponential search
+	UIntT step(1);
+	UIntT up(lo);
+	do
+	{
+		lo = up;
+		up = (hi-lo > step) ? lo+step : hi;
+		step *= 2;
+	}
+	while (up < hi && !students_t_sample_size_ok(cache, c, p, up));
+
+	// Bisection on (lo,up]
+	while (up-lo > 1)
+	{
+		const UIntT mid(lo+(up-lo)/2);
+
+		if (students_t_sample_size_ok(cache, c, p, mid))
+		{
+			up = mid;
+		}
+		else
+		{
+			lo = mid;
+		}
+	}
+
+	return up;
+}
+
+}}} // Namespace dcs::des::detail
+
+
+#endif // DCS_DES_DETAIL_QUANTILE_CACHE_HPP
@@ -0,0 +1,216 @@
+/**
+ * \file dcs/des/detail/ring_buffer.hpp
+ *
+ * \brief Fixed-capacity ring buffer with contiguous storage.
+ *
+ * Copyright (C) 2012       Distributed Computing System (DCS) Group,
+ *                          Computer Science Institute,
+ *                          Department of Science and Technological Innovation,
+ *                          University of Piemonte Orientale,
+ *                          Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_DETAIL_RING_BUFFER_HPP
+#define DCS_DES_DETAIL_RING_BUFFER_HPP
+
+
+#include <cstddef>
+#include <dcs/debug.hpp>
+#include <vector>
+
+
+namespace dcs { namespace des { namespace detail {
+
+/**
+ * \brief Fixed-capacity ring buffer with contiguous storage.
+ *
+ * The storage holds two copies of the ring (each element is written both at
+ * its position and at the same position plus the capacity), so that the
+ * elements, from the oldest to the newest, always lie in the contiguous range
+ * of positions \f$[\mathrm{offset}, \mathrm{offset}+\mathrm{size})\f$ of the
+ * storage.
+ * Hence, views of (parts of) the buffer can be taken without copying or
+ * rearranging elements, at the cost of a double write for each insertion.
+ *
+ * Adding an element to a full buffer overwrites the oldest one; removing
+ * elements from the front is a constant-time operation.
+ *
+ * \tparam T The element type.
+ * \tparam ContainerT The type of the underlying storage; it must be a
+ *  random-access container with contiguous storage which is constructible
+ *  from its size (e.g., \c std::vector or \c boost::numeric::ublas::vector).
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename T, typename ContainerT = ::std::vector<T> >
+class ring_buffer
+{
+	public: typedef T value_type;
+	public: typedef ContainerT container_type;
+	public: typedef ::std::size_t size_type;
+
+
+	/// Create a ring buffer with the given capacity.
+	public: explicit ring_buffer(size_type capacity = 0)
+	: storage_(2*capacity),
+	  capacity_(capacity),
+	  head_(0),
+	  size_(0)
+	{
+		// empty
+	}
+
+
+	/// Remove all the elements and change the capacity to \a capacity.
+	public: void reset(size_type capacity)
+	{
+		if (capacity != capacity_)
+		{
+			storage_ = container_type(2*capacity);
+			capacity_ = capacity;
+		}
+		clear();
+	}
+
+
+	/// Remove all the elements.
+	public: void clear()
+	{
+		head_ = size_
+			  = 0;
+	}
+
+
+	/// Add a new element, overwriting the oldest one if the buffer is full.
+	public: void push_back(value_type const& x)
+	{
+		// pre: capacity() > 0
+		DCS_DEBUG_ASSERT( capacity_ > 0 );
+
+		size_type pos(head_+size_);
+		if (pos >= capacity_)
+		{
+			pos -= capacity_;
+		}
+		storage_[pos] = x;
+		storage_[pos+capacity_] = x;
+
+		if (size_ < capacity_)
+		{
+			++size_;
+		}
+		else
+		{
+			++head_;
+			if (head_ == capacity_)
+			{
+				head_ = 0;
+			}
+		}
+	}
+
+
+	/// Remove the \a n oldest elements.
+	public: void pop_front(size_type n = 1)
+	{
+		// pre: n <= size()
+		DCS_DEBUG_ASSERT( n <= size_ );
+
+		head_ += n;
+		if (head_ >= capacity_)
+		{
+			head_ -= capacity_;
+		}
+		size_ -= n;
+	}
+
+
+	/// Return the \a i-th oldest element.
+	public: value_type const& operator[](size_type i) const
+	{
+		// pre: i < size()
+		DCS_DEBUG_ASSERT( i < size_ );
+
+		return storage_[head_+i];
+	}
+
+
+	/// Return a pointer to the oldest element (elements are contiguous).
+	public: value_type const* data() const
+	{
+		return capacity_ > 0 ? &storage_[head_] : 0;
+	}
+
+
+	/**
+	 * \brief Return the underlying storage.
+	 *
+	 * The elements are at positions \f$[\mathrm{offset}(),
+	 * \mathrm{offset}()+\mathrm{size}())\f$.
+	 */
+	public: container_type const& storage() const
+	{
+		return storage_;
+	}
+
+
+	/// Return the position of the oldest element in the underlying storage.
+	public: size_type offset() const
+	{
+		return head_;
+	}
+
+
+	public: size_type size() const
+	{
+		return size_;
+	}
+
+
+	public: size_type capacity() const
+	{
+		return capacity_;
+	}
+
+
+	public: bool empty() const
+	{
+		return size_ == 0;
+	}
+
+
+	public: bool full() const
+	{
+		return size_ == capacity_;
+	}
+
+
+	/// The underlying storage (twice the capacity).
+	private: container_type storage_;
+	/// The maximum number of elements.
+	private: size_type capacity_;
+	/// The position of the oldest element.
+	private: size_type head_;
+	/// The number of elements.
+	private: size_type size_;
+};
+
+}}} // Namespace dcs::des::detail
+
+
+#endif // DCS_DES_DETAIL_RING_BUFFER_HPP
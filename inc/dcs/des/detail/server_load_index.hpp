@@ -0,0 +1,177 @@
+/**
+ * \file dcs/des/detail/server_load_index.hpp
+ *
+ * \brief Index of the load of a set of servers, for least-loaded server
+ *  selection.
+ *
+ * Copyright (C) 2012       Distributed Computing System (DCS) Group,
+ *                          Computer Science Institute,
+ *                          Department of Science and Technological Innovation,
+ *                          University of Piemonte Orientale,
+ *                          Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_DETAIL_SERVER_LOAD_INDEX_HPP
+#define DCS_DES_DETAIL_SERVER_LOAD_INDEX_HPP
+
+
+#include <cstddef>
+#include <dcs/debug.hpp>
+#include <set>
+#include <vector>
+
+
+namespace dcs { namespace des { namespace detail {
+
+/**
+ * \brief Index of the load (e.g., the number of customers) of a set of
+ *  servers, for least-loaded server selection.
+ *
+ * Servers are kept in buckets by load, and each bucket is ordered by server
+ * identifier.
+ * The least-loaded server following (in circular order) a given one is
+ * found in \f$O(\log n)\f$ time, where \f$n\f$ is the number of servers,
+ * and changing the load of a server by one costs \f$O(\log n)\f$ time as
+ * well.
+ *
+ * \tparam UIntT The type used for server identifiers and loads.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename UIntT>
+class server_load_index
+{
+	public: typedef UIntT uint_type;
+	private: typedef ::std::set<uint_type> server_set;
+	private: typedef ::std::vector<server_set> bucket_container;
+
+
+	/// Create an index of \a num_servers servers with no load.
+	public: explicit server_load_index(uint_type num_servers = 0)
+	: loads_(),
+	  buckets_(),
+	  min_load_(0)
+	{
+		reset(num_servers);
+	}
+
+
+	/// Remove the load of all the servers and change their number to \a num_servers.
+	public: void reset(uint_type num_servers)
+	{
+		loads_.assign(num_servers, 0);
+		buckets_.assign(1, server_set());
+		for (uint_type sid = 0; sid < num_servers; ++sid)
+		{
+			buckets_[0].insert(buckets_[0].end(), sid);
+		}
+		min_load_ = 0;
+	}
+
+
+	/// Set the load of the given server.
+	public: void load(uint_type sid, uint_type value)
+	{
+		// pre: sid < num_servers()
+		DCS_DEBUG_ASSERT( sid < loads_.size() );
+
+		const uint_type old_value(loads_[sid]);
+
+		if (value == old_value)
+		{
+			return;
+		}
+
+		if (value >= buckets_.size())
+		{
+			buckets_.resize(value+1);
+		}
+		buckets_[old_value].erase(sid);
+		buckets_[value].insert(sid);
+		loads_[sid] = value;
+
+		if (value < min_load_)
+		{
+			min_load_ = value;
+		}
+		else
+		{
+			// The bucket of the new load is not empty, so the loop ends
+			while (buckets_[min_load_].empty())
+			{
+				++min_load_;
+			}
+		}
+	}
+
+
+	/// Return the load of the given server.
+	public: uint_type load(uint_type sid) const
+	{
+		// pre: sid < num_servers()
+		DCS_DEBUG_ASSERT( sid < loads_.size() );
+
+		return loads_[sid];
+	}
+
+
+	/**
+	 * \brief Return the first least-loaded server, in circular order,
+	 *  starting from (and including) \a start_sid.
+	 */
+	public: uint_type least_loaded(uint_type start_sid) const
+	{
+		// pre: start_sid < num_servers()
+		DCS_DEBUG_ASSERT( start_sid < loads_.size() );
+
+		if (loads_[start_sid] == min_load_)
+		{
+			return start_sid;
+		}
+
+		server_set const& bucket(buckets_[min_load_]);
+
+		typename server_set::const_iterator it(bucket.lower_bound(start_sid));
+		if (it == bucket.end())
+		{
+			// Wrap around
+			it = bucket.begin();
+		}
+
+		return *it;
+	}
+
+
+	public: uint_type num_servers() const
+	{
+		return loads_.size();
+	}
+
+
+	/// The load of each server.
+	private: ::std::vector<uint_type> loads_;
+	/// The servers grouped by load.
+	private: bucket_container buckets_;
+	/// The smallest load.
+	private: uint_type min_load_;
+};
+
+}}} // Namespace dcs::des::detail
+
+
+#endif // DCS_DES_DETAIL_SERVER_LOAD_INDEX_HPP
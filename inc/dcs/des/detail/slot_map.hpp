@@ -0,0 +1,332 @@
+/**
+ * \file dcs/des/detail/slot_map.hpp
+ *
+ * \brief Associative container with dense storage and generation-checked
+ *  keys.
+ *
+ * Copyright (C) 2012       Distributed Computing System (DCS) Group,
+ *                          Computer Science Institute,
+ *                          Department of Science and Technological Innovation,
+ *                          University of Piemonte Orientale,
+ *                          Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_DETAIL_SLOT_MAP_HPP
+#define DCS_DES_DETAIL_SLOT_MAP_HPP
+
+
+#include <cstddef>
+#include <dcs/debug.hpp>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+
+namespace dcs { namespace des { namespace detail {
+
+/// The key of an element of a slot_map.
+struct slot_map_key
+{
+	slot_map_key()
+	: index(::std::numeric_limits< ::std::size_t >::max()),
+	  generation(0)
+	{
+	}
+
+	slot_map_key(::std::size_t idx, ::std::size_t gen)
+	: index(idx),
+	  generation(gen)
+	{
+	}
+
+	::std::size_t index; ///< The slot of the element.
+	::std::size_t generation; ///< The generation of the slot when the element has been inserted.
+};
+
+
+inline
+bool operator==(slot_map_key const& a, slot_map_key const& b)
+{
+	return a.index == b.index && a.generation == b.generation;
+}
+
+
+inline
+bool operator!=(slot_map_key const& a, slot_map_key const& b)
+{
+	return !(a == b);
+}
+
+
+inline
+bool operator<(slot_map_key const& a, slot_map_key const& b)
+{
+	return a.index < b.index || (a.index == b.index && a.generation < b.generation);
+}
+
+
+template <typename CharT, typename CharTraitsT>
+::std::basic_ostream<CharT,CharTraitsT>& operator<<(::std::basic_ostream<CharT,CharTraitsT>& os, slot_map_key const& key)
+{
+	return os << "<" << key.index << "," << key.generation << ">";
+}
+
+
+/**
+ * \brief Associative container with dense storage and generation-checked
+ *  keys.
+ *
+ * Keys are generated by the container on insertion.
+ * Each key refers to a slot and holds the generation of the slot at the time
+ * of the insertion; the generation of a slot is incremented every time its
+ * element is erased, so that keys of erased elements are recognized as
+ * stale, even when the slot has been reused.
+ * Free slots are kept in a free list.
+ *
+ * Elements are stored contiguously (erasing an element moves the last one in
+ * its place), so that iteration is cache-friendly.
+ * Insertion, erasure and lookup take constant time, and no memory is
+ * allocated for each element (apart from the amortized growth of the
+ * underlying vectors).
+ *
+ * Note that insertions and erasures invalidate references and iterators to
+ * elements (but not keys).
+ *
+ * \tparam T The element type (it must be default constructible and
+ *  assignable).
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename T>
+class slot_map
+{
+	public: typedef T value_type;
+	public: typedef slot_map_key key_type;
+	public: typedef ::std::size_t size_type;
+	private: typedef ::std::vector<value_type> value_container;
+	public: typedef typename value_container::iterator iterator;
+	public: typedef typename value_container::const_iterator const_iterator;
+	private: struct slot
+	{
+		/// The position of the element in the dense storage, if the slot is
+		/// used, or the next free slot, otherwise.
+		size_type pos;
+		/// The current generation of the slot.
+		size_type generation;
+	};
+	private: typedef ::std::vector<slot> slot_container;
+
+
+	public: slot_map()
+	: slots_(),
+	  values_(),
+	  slot_of_(),
+	  free_head_(npos())
+	{
+		// empty
+	}
+
+
+	/// Insert a new element and return its key.
+	public: key_type insert(value_type const& value)
+	{
+		size_type idx(free_head_);
+
+		if (idx != npos())
+		{
+			free_head_ = slots_[idx].pos;
+		}
+		else
+		{
+			idx = slots_.size();
+			slot s;
+			s.generation = 0;
+			slots_.push_back(s);
+		}
+
+		slots_[idx].pos = values_.size();
+		values_.push_back(value);
+		slot_of_.push_back(idx);
+
+		return key_type(idx, slots_[idx].generation);
+	}
+
+
+	/// Erase the element with the given key; return \c false if the key is stale.
+	public: bool erase(key_type const& key)
+	{
+		if (!contains(key))
+		{
+			return false;
+		}
+
+		const size_type pos(slots_[key.index].pos);
+		const size_type last(values_.size()-1);
+
+		if (pos != last)
+		{
+			// Move the last element in place of the erased one
+			values_[pos] = values_[last];
+			slot_of_[pos] = slot_of_[last];
+			slots_[slot_of_[pos]].pos = pos;
+		}
+		values_.pop_back();
+		slot_of_.pop_back();
+
+		free_slot(key.index);
+
+		return true;
+	}
+
+
+	/// Remove all the elements (keys of removed elements become stale).
+	public: void clear()
+	{
+		const size_type n(slot_of_.size());
+		for (size_type pos = 0; pos < n; ++pos)
+		{
+			free_slot(slot_of_[pos]);
+		}
+		values_.clear();
+		slot_of_.clear();
+	}
+
+
+	/// Tell if the given key refers to an element of this container.
+	public: bool contains(key_type const& key) const
+	{
+		return key.index < slots_.size()
+			   && slots_[key.index].generation == key.generation;
+	}
+
+
+	/// Return a pointer to the element with the given key, or a null pointer if the key is stale.
+	public: value_type* find(key_type const& key)
+	{
+		return contains(key) ? &values_[slots_[key.index].pos] : 0;
+	}
+
+
+	/// Return a pointer to the element with the given key, or a null pointer if the key is stale.
+	public: value_type const* find(key_type const& key) const
+	{
+		return contains(key) ? &values_[slots_[key.index].pos] : 0;
+	}
+
+
+	public: value_type& operator[](key_type const& key)
+	{
+		// pre: contains(key)
+		DCS_DEBUG_ASSERT( contains(key) );
+
+		return values_[slots_[key.index].pos];
+	}
+
+
+	public: value_type const& operator[](key_type const& key) const
+	{
+		// pre: contains(key)
+		DCS_DEBUG_ASSERT( contains(key) );
+
+		return values_[slots_[key.index].pos];
+	}
+
+
+	/// Return the key of the element at position \a pos of the dense storage.
+	public: key_type key(size_type pos) const
+	{
+		// pre: pos < size()
+		DCS_DEBUG_ASSERT( pos < values_.size() );
+
+		const size_type idx(slot_of_[pos]);
+
+		return key_type(idx, slots_[idx].generation);
+	}
+
+
+	public: iterator begin()
+	{
+		return values_.begin();
+	}
+
+
+	public: iterator end()
+	{
+		return values_.end();
+	}
+
+
+	public: const_iterator begin() const
+	{
+		return values_.begin();
+	}
+
+
+	public: const_iterator end() const
+	{
+		return values_.end();
+	}
+
+
+	public: size_type size() const
+	{
+		return values_.size();
+	}
+
+
+	public: bool empty() const
+	{
+		return values_.empty();
+	}
+
+
+	/// Return the number of slots (that is, one plus the greatest slot index used so far).
+	public: size_type num_slots() const
+	{
+		return slots_.size();
+	}
+
+
+	private: void free_slot(size_type idx)
+	{
+		++slots_[idx].generation;
+		slots_[idx].pos = free_head_;
+		free_head_ = idx;
+	}
+
+
+	private: static size_type npos()
+	{
+		return ::std::numeric_limits<size_type>::max();
+	}
+
+
+	/// The slots.
+	private: slot_container slots_;
+	/// The elements (densely stored).
+	private: value_container values_;
+	/// The slot of each element of the dense storage.
+	private: ::std::vector<size_type> slot_of_;
+	/// The head of the list of free slots.
+	private: size_type free_head_;
+};
+
+}}} // Namespace dcs::des::detail
+
+
+#endif // DCS_DES_DETAIL_SLOT_MAP_HPP
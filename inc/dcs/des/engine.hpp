@@ -40,8 +40,11 @@
 #include <dcs/des/any_statistic.hpp>
 #include <dcs/des/base_analyzable_statistic.hpp>
 #include <dcs/des/base_statistic.hpp>
+#include <dcs/des/detail/event_sink_list.hpp>
+#include <dcs/des/detail/pool_allocator.hpp>
 #include <dcs/des/event.hpp>
 #include <dcs/des/engine_context.hpp>
+#include <dcs/des/event_firing_hooks.hpp>
 #include <dcs/des/event_list.hpp>
 #include <dcs/des/event_source.hpp>
 #include <dcs/exception.hpp>
@@ -50,7 +53,7 @@
 //#include <functional>
 #include <iostream>
 //#include <queue>
-//#include <vector>
+#include <vector>
 #include <map>
 
 
@@ -84,22 +87,29 @@ namespace dcs { namespace des {
  * \author Marco Guazzone (marco.guazzone@gmail.com)
  */
 template <typename RealT=double>
-class engine
+class engine: private analyzable_statistic_listener<RealT,::std::size_t>
 {
 	private: typedef engine<RealT> self_type;
 	public: typedef RealT real_type;
 	public: typedef ::std::size_t size_type;
 	public: typedef event<RealT> event_type;
 	public: typedef ::boost::shared_ptr<event_type> event_pointer;
+	private: typedef detail::pool_allocator<event_type> event_allocator_type;
 	public: typedef engine_context<real_type> engine_context_type;
 	public: typedef event_source<real_type> event_source_type;
 	public: typedef ::boost::shared_ptr<event_source_type> event_source_pointer;
+	/// The type of the connection between the engine and an event-firing observer.
+	public: typedef detail::event_sink_connection<event_type,engine_context_type> observer_connection_type;
+	private: typedef detail::event_sink_list<event_type,engine_context_type> observer_list_type;
+	private: typedef ::boost::shared_ptr<observer_list_type> observer_list_pointer;
 //	public: typedef base_statistic<real_type,size_type> statistic_type;
 	public: typedef any_statistic<real_type,size_type> statistic_type;
 	public: typedef base_analyzable_statistic<real_type,size_type> analyzable_statistic_type;
 	public: typedef ::boost::shared_ptr<analyzable_statistic_type> analyzable_statistic_pointer;
+	private: typedef analyzable_statistic_listener<real_type,size_type> analyzable_statistic_listener_type;
 	//private: typedef ::std::vector<analyzable_statistic_pointer> analyzable_statistic_container;
 	private: typedef ::std::map<analyzable_statistic_pointer,bool> analyzable_statistic_container;
+	protected: typedef ::std::vector<analyzable_statistic_pointer> time_dependent_statistic_container;
 	protected: typedef typename analyzable_statistic_container::iterator analyzable_statistic_iterator;
 	protected: typedef typename analyzable_statistic_container::const_iterator analyzable_statistic_const_iterator;
 
@@ -110,21 +120,31 @@ class engine
 	/// The default constructor.
 	public: engine()
 		: evt_list_(),
+		  ptr_evt_pool_(new detail::fixed_size_pool()),
 		  ptr_bos_evt_src_(new event_source_type("Begin of Simulation")),
 		  ptr_eos_evt_src_(new event_source_type("End of Simulation")),
 		  ptr_bef_evt_src_(new event_source_type("Before Event Firing")),
 		  ptr_aef_evt_src_(new event_source_type("After Event Firing")),
 		  ptr_si_evt_src_(new event_source_type("System Initialization")),
 		  ptr_sf_evt_src_(new event_source_type("System Finalization")),
+		  ptr_bef_obs_(new observer_list_type()),
+		  ptr_aef_obs_(new observer_list_type()),
 		  sim_time_(0),
 		  last_evt_time_(0),
 		  end_of_sim_(true),
 		  num_events_(0),
 		  num_usr_events_(0),
-		  mon_stats_()
+		  mon_stats_(),
+		  num_unsatisfied_stats_(0),
+		  num_new_steady_stats_(0),
+		  num_incomplete_stats_(0),
+		  time_dep_stats_()
 		  //ptr_mon_stat_()
 	{
-		// empty
+		ptr_bos_evt_src_->internal(true);
+		ptr_eos_evt_src_->internal(true);
+		ptr_bef_evt_src_->internal(true);
+		ptr_aef_evt_src_->internal(true);
 	}
 
 
@@ -149,6 +169,8 @@ class engine
 	/// The destructor.
 	public: virtual ~engine()
 	{
+		// Monitored statistics may outlive this engine
+		remove_statistics();
 	}
 
 
@@ -159,6 +181,9 @@ class engine
 	 * \brief Add a new event to be scheduled at the specified time.
 	 * \param ptr_src The event source which will fire the event.
 	 * \param time The time the event is to be scheduled.
+	 * \return A stable handle to the scheduled event, to be used for
+	 *  rescheduling or cancelling it (see \c reschedule_event and
+	 *  \c cancel_event), or a null pointer if the event source is disabled.
 	 */
 	//public: void schedule_event(event_source_pointer const& ptr_src, real_type time)
 	public: event_pointer schedule_event(event_source_pointer const& ptr_src, real_type time)
@@ -187,8 +212,9 @@ class engine
 		}
 
 //		evt_list_.push(event_type(ptr_src, time));
-		event_pointer ptr_evt = ::boost::make_shared<event_type>(ptr_src, sim_time_, time);
-		evt_list_.push(ptr_evt);
+		//event_pointer ptr_evt = ::boost::make_shared<event_type>(ptr_src, sim_time_, time);
+		event_pointer ptr_evt = ::boost::allocate_shared<event_type>(event_allocator_type(ptr_evt_pool_), ptr_src, sim_time_, time);
+		enqueue_event(ptr_evt);
 		return ptr_evt;
 	}
 
@@ -197,6 +223,10 @@ class engine
 	 * \brief Add a new event to be scheduled at the specified time.
 	 * \param ptr_src The event source which will fire the event.
 	 * \param time The time the event is to be scheduled.
+	 * \param state The state to attach to the event.
+	 * \return A stable handle to the scheduled event, to be used for
+	 *  rescheduling or cancelling it (see \c reschedule_event and
+	 *  \c cancel_event), or a null pointer if the event source is disabled.
 	 */
 	public: template <typename T>
 		//void schedule_event(event_source_pointer const& ptr_src, real_type time, T const& state)
@@ -226,17 +256,34 @@ class engine
 		}
 
 //		evt_list_.push(event_type(ptr_src, time, state));
-		event_pointer ptr_evt = ::boost::make_shared<event_type>(ptr_src, sim_time_, time, state);
-		evt_list_.push(ptr_evt);
+		//event_pointer ptr_evt = ::boost::make_shared<event_type>(ptr_src, sim_time_, time, state);
+		event_pointer ptr_evt = ::boost::allocate_shared<event_type>(event_allocator_type(ptr_evt_pool_), ptr_src, sim_time_, time, state);
+		enqueue_event(ptr_evt);
 		return ptr_evt;
 	}
 
 
+	/**
+	 * \brief Change the fire time of an already scheduled event.
+	 * \param ptr_evt The handle to the event, as returned by
+	 *  \c schedule_event.
+	 * \param time The new fire time.
+	 *
+	 * Stale handles (i.e., handles to events already fired or cancelled) are
+	 * detected in constant time and ignored.
+	 * With the default event list, the event is moved in logarithmic time.
+	 */
 	public: void reschedule_event(event_pointer const& ptr_evt, real_type time)
 	{
 		// check: paranoid check
 		DCS_DEBUG_ASSERT( ptr_evt );
 
+		if (!ptr_evt->scheduled())
+		{
+			DCS_DEBUG_TRACE_L(1, "Event " << *ptr_evt << " not rescheduled since it is no more in the event list.");
+			return;
+		}
+
 		if (!ptr_evt->source().enabled())
 		{
 			::std::clog << "[Warning] Tried to reschedule an event from the disabled event source '" << ptr_evt->source() << "' at time: " << time << " (Clock: " << sim_time_ << ")" << ::std::endl;
@@ -275,7 +322,26 @@ class engine
 //		evt_list_.touch(ptr_evt);
 		evt_list_.erase(ptr_evt);
 		ptr_evt->fire_time(time);
-		evt_list_.push(ptr_evt);
+		enqueue_event(ptr_evt);
+	}
+
+
+	/**
+	 * \brief Remove an already scheduled event from the event list.
+	 * \param ptr_evt The handle to the event, as returned by
+	 *  \c schedule_event.
+	 * \return \c true if the event has been cancelled; \c false if the handle
+	 *  is stale (i.e., the event has already been fired or cancelled).
+	 *
+	 * Stale handles are detected in constant time.
+	 * With the default event list, the event is removed in logarithmic time.
+	 */
+	public: bool cancel_event(event_pointer const& ptr_evt)
+	{
+		// check: paranoid check
+		DCS_DEBUG_ASSERT( ptr_evt );
+
+		return evt_list_.erase(ptr_evt);
 	}
 
 
@@ -344,6 +410,8 @@ class engine
 	 *
 	 * The user may attach to this event source one or more event sinks in order
 	 * to perform some final operation before the event is fired.
+	 *
+	 * \sa connect_before_event_firing_observer, which is much cheaper.
 	 */
 	public: event_source_type& before_of_event_firing_source()
 	{
@@ -373,6 +441,8 @@ class engine
 	 *
 	 * The user may attach to this event source one or more event sinks in order
 	 * to perform some final operation after the event is fired.
+	 *
+	 * \sa connect_after_event_firing_observer, which is much cheaper.
 	 */
 	public: event_source_type& after_of_event_firing_source()
 	{
@@ -395,6 +465,42 @@ class engine
 	}
 
 
+	/**
+	 * \brief Add an observer to be notified just before each event is fired.
+	 * \param obs The observer, that is a callable object with signature
+	 *  <code>void (event_type const& evt, engine_context_type& ctx)</code>,
+	 *  where \a evt is the event about to be fired.
+	 * \return The connection, to be used for removing the observer.
+	 *
+	 * Unlike the sinks attached to the <em>BEFORE-OF-EVENT-FIRING</em> event
+	 * source, observers receive the firing event itself: no internal event is
+	 * created and no event is counted.
+	 */
+	public: template <typename ObserverT>
+		observer_connection_type connect_before_event_firing_observer(ObserverT const& obs)
+	{
+		return observer_connection_type(ptr_bef_obs_, ptr_bef_obs_->connect(obs));
+	}
+
+
+	/**
+	 * \brief Add an observer to be notified just after each event is fired.
+	 * \param obs The observer, that is a callable object with signature
+	 *  <code>void (event_type const& evt, engine_context_type& ctx)</code>,
+	 *  where \a evt is the event just fired.
+	 * \return The connection, to be used for removing the observer.
+	 *
+	 * Unlike the sinks attached to the <em>AFTER-OF-EVENT-FIRING</em> event
+	 * source, observers receive the fired event itself: no internal event is
+	 * created and no event is counted.
+	 */
+	public: template <typename ObserverT>
+		observer_connection_type connect_after_event_firing_observer(ObserverT const& obs)
+	{
+		return observer_connection_type(ptr_aef_obs_, ptr_aef_obs_->connect(obs));
+	}
+
+
 	/**
 	 * \brief Return the event source related to the
 	 *  <em>SYSTEM-INITIALIZATION</em> event.
@@ -463,8 +569,26 @@ class engine
 	 */
 	public: void analyze_statistic(analyzable_statistic_pointer const& ptr_stat)
 	{
+		if (mon_stats_.count(ptr_stat) > 0)
+		{
+			detach_statistic(ptr_stat);
+		}
+
 		//mon_stats_.push_back(ptr_stat);
 		mon_stats_[ptr_stat] = ptr_stat->steady_state_entered();
+		ptr_stat->listener(static_cast<analyzable_statistic_listener_type*>(this));
+		if (!ptr_stat->precision_satisfied())
+		{
+			++num_unsatisfied_stats_;
+		}
+		if (!ptr_stat->completion_satisfied())
+		{
+			++num_incomplete_stats_;
+		}
+		if (ptr_stat->time_dependent())
+		{
+			time_dep_stats_.push_back(ptr_stat);
+		}
 
 		if (!end_of_sim_)
 		{
@@ -493,6 +617,7 @@ class engine
 				DCS_EXCEPTION_THROW( ::std::invalid_argument, "Statistic not analyzed." )
 			);
 
+		detach_statistic(ptr_stat);
 		mon_stats_.erase(ptr_stat);
 	}
 
@@ -501,7 +626,20 @@ class engine
 	//public: void ignore_statistics()
 	public: void remove_statistics()
 	{
+		analyzable_statistic_iterator end_it(mon_stats_.end());
+		for (
+			analyzable_statistic_iterator it = mon_stats_.begin();
+			it != end_it;
+			++it
+		) {
+			detach_statistic(it->first);
+		}
+
 		mon_stats_.clear();
+		time_dep_stats_.clear();
+		num_unsatisfied_stats_ = num_new_steady_stats_
+							   = num_incomplete_stats_
+							   = 0;
 	}
 
 
@@ -571,6 +709,51 @@ class engine
 	}
 
 
+	/**
+	 * \brief Set the policy used to remove cancelled or rescheduled events
+	 *  from the future event list.
+	 * \param value The event removal policy.
+	 *
+	 * It must be called while no event is scheduled (e.g., before running
+	 * the simulation).
+	 */
+	public: void event_removal(event_removal_policy value)
+	{
+		evt_list_.removal_policy(value);
+	}
+
+
+	/**
+	 * \brief Return the policy used to remove cancelled or rescheduled events
+	 *  from the future event list.
+	 */
+	public: event_removal_policy event_removal() const
+	{
+		return evt_list_.removal_policy();
+	}
+
+
+	/**
+	 * \brief Set the fraction of dead entries above which the future event
+	 *  list is compacted, with lazy event removal.
+	 * \param value The compaction threshold.
+	 */
+	public: void event_list_compaction_threshold(double value)
+	{
+		evt_list_.compaction_threshold(value);
+	}
+
+
+	/**
+	 * \brief Return the fraction of dead entries above which the future event
+	 *  list is compacted, with lazy event removal.
+	 */
+	public: double event_list_compaction_threshold() const
+	{
+		return evt_list_.compaction_threshold();
+	}
+
+
 //	// Maybe useless
 //	protected: size_type num_events() const
 //	{
@@ -630,12 +813,19 @@ class engine
 	}
 
 
+	/**
+	 * \brief Tell if the given event is an engine-internal event.
+	 *
+	 * Events are classified by the flag they take from their source (see
+	 * \c event_source::internal), so that no comparison against the internal
+	 * event sources is needed.
+	 * Derived engines with further internal event sources only need to mark
+	 * such sources as internal; engines overriding this member function can
+	 * still classify events in a different way.
+	 */
 	protected: virtual bool is_internal_event(event_type const& evt) const
 	{
-		return evt.source() == *ptr_bos_evt_src_
-			   || evt.source() == *ptr_eos_evt_src_
-			   || evt.source() == *ptr_bef_evt_src_
-			   || evt.source() == *ptr_aef_evt_src_;
+		return evt.internal();
 	}
 
 
@@ -670,6 +860,10 @@ class engine
 
 		evt_list_.clear();
 
+		// Give back the memory of pooled events at once (only possible when
+		// no event is referenced anymore; otherwise, blocks will be recycled)
+		ptr_evt_pool_->release();
+
 		// NO! This clash with specialized engines (like independent replications) which call this method.
 		// Reset statistics
 		//reset_statistics();
@@ -677,6 +871,40 @@ class engine
 
 
 	protected: virtual void prepare_simulation(engine_context_type& ctx)
+	{
+		prepare_simulation<with_event_firing_hooks>(ctx);
+	}
+
+
+	protected: virtual void finalize_simulation(engine_context_type& ctx)
+	{
+		finalize_simulation<with_event_firing_hooks>(ctx);
+	}
+
+
+	protected: virtual void initialize_simulated_system(engine_context_type& ctx)
+	{
+		initialize_simulated_system<with_event_firing_hooks>(ctx);
+	}
+
+
+	protected: virtual void finalize_simulated_system(engine_context_type& ctx)
+	{
+		finalize_simulated_system<with_event_firing_hooks>(ctx);
+	}
+
+
+	/**
+	 * \brief Prepare the simulation and fire the BEGIN-OF-SIMULATION event.
+	 *
+	 * \tparam FiringHooksT The policy for the BEFORE/AFTER-EVENT-FIRING events
+	 *  (see \c with_event_firing_hooks and \c without_event_firing_hooks).
+	 *
+	 * Engines parameterized by a firing-hooks policy override the related
+	 * virtual member function to call this one with their own policy.
+	 */
+	protected: template <typename FiringHooksT>
+		void prepare_simulation(engine_context_type& ctx)
 	{
 		// Clear simulation state
 		reset();
@@ -689,11 +917,13 @@ class engine
 //		// Fire the begin of simulation event
 //		fire_next_event(ctx);
 		// Immediately (schedule and) fire the BEGIN-OF-SIMULATION event
-		fire_immediate_event(ptr_bos_evt_src_, ctx);
+		fire_immediate_event<FiringHooksT>(ptr_bos_evt_src_, ctx);
 	}
 
 
-	protected: virtual void finalize_simulation(engine_context_type& ctx)
+	/// Finalize the simulation and fire the END-OF-SIMULATION event.
+	protected: template <typename FiringHooksT>
+		void finalize_simulation(engine_context_type& ctx)
 	{
 		DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( ctx );
 
@@ -713,33 +943,52 @@ class engine
 
 		// Immediately (schedule and) fire the END-OF-SIMULATION event
 //		engine_context_type ctx(this);
-		fire_immediate_event(ptr_eos_evt_src_, ctx);
+		fire_immediate_event<FiringHooksT>(ptr_eos_evt_src_, ctx);
 	}
 
 
-	protected: virtual void initialize_simulated_system(engine_context_type& ctx)
+	/// Fire the SYSTEM-INITIALIZATION event.
+	protected: template <typename FiringHooksT>
+		void initialize_simulated_system(engine_context_type& ctx)
 	{
 //		// Schedule the system-initialization event now...
 //		schedule_event(ptr_si_evt_src_, sim_time_);
 //		// ... and immediately fire it
 //		fire_next_event(ctx);
 		// Immediately (schedule and) fire the SYSTEM-INITIALIZATION event
-		fire_immediate_event(ptr_si_evt_src_, ctx);
+		fire_immediate_event<FiringHooksT>(ptr_si_evt_src_, ctx);
 	}
 
 
-	protected: virtual void finalize_simulated_system(engine_context_type& ctx)
+	/// Fire the SYSTEM-FINALIZATION event.
+	protected: template <typename FiringHooksT>
+		void finalize_simulated_system(engine_context_type& ctx)
 	{
 //		// Schedule the system-initialization event now...
 //		schedule_event(ptr_sf_evt_src_, sim_time_);
 //		// ... and immediately fire it
 //		fire_next_event(ctx);
 		// Immediately (schedule and) fire the SYSTEM-FINALIZATION event
-		fire_immediate_event(ptr_sf_evt_src_, ctx);
+		fire_immediate_event<FiringHooksT>(ptr_sf_evt_src_, ctx);
 	}
 
 
+	/// Fire the next event in the event list.
 	protected: void fire_next_event(engine_context_type& ctx)
+	{
+		fire_next_event<with_event_firing_hooks>(ctx);
+	}
+
+
+	/**
+	 * \brief Fire the next event in the event list.
+	 *
+	 * \tparam FiringHooksT The policy for the BEFORE/AFTER-EVENT-FIRING events
+	 *  (see \c with_event_firing_hooks and \c without_event_firing_hooks);
+	 *  when these events are disabled, the related code is compiled away.
+	 */
+	protected: template <typename FiringHooksT>
+		void fire_next_event(engine_context_type& ctx)
 	{
 		if (!evt_list_.empty())
 		{
@@ -773,8 +1022,14 @@ class engine
 			//DCS_DEBUG_TRACE_L(1, "Firing EVENT #" << num_events_ << ": " << cur_evt );
 			DCS_DEBUG_TRACE_L(1, "Firing EVENT #" << num_events_ << ": " << *ptr_cur_evt );
 
+			// Notify the before-event-firing observers
+			if (FiringHooksT::enabled && !ptr_bef_obs_->empty())
+			{
+				ptr_bef_obs_->emit(*ptr_cur_evt, ctx);
+			}
+
 			// Firing the before-event-firing event
-			if (!ptr_bef_evt_src_->empty())
+			if (FiringHooksT::enabled && !ptr_bef_evt_src_->empty())
 			{
 				//event_type(ptr_bef_evt_src_, sim_time_, cur_evt).fire(ctx);
 				make_internal_event(ptr_bef_evt_src_, *ptr_cur_evt).fire(ctx);
@@ -784,8 +1039,14 @@ class engine
 			//cur_evt.fire(ctx);
 			ptr_cur_evt->fire(ctx);
 
+			// Notify the after-event-firing observers
+			if (FiringHooksT::enabled && !ptr_aef_obs_->empty())
+			{
+				ptr_aef_obs_->emit(*ptr_cur_evt, ctx);
+			}
+
 			// Firing the after-event-firing event
-			if (!ptr_aef_evt_src_->empty())
+			if (FiringHooksT::enabled && !ptr_aef_evt_src_->empty())
 			{
 				//event_type(ptr_aef_evt_src_, sim_time_, cur_evt).fire(ctx);
 				make_internal_event(ptr_aef_evt_src_, *ptr_cur_evt).fire(ctx);
@@ -796,7 +1057,7 @@ class engine
 
 			// Check for the end-of-simulation event
 			//if (cur_evt.source() == *ptr_eos_evt_src_)
-			if (ptr_cur_evt->source() == *ptr_eos_evt_src_)
+			if (ptr_cur_evt->internal() && ptr_cur_evt->source() == *ptr_eos_evt_src_)
 			{
 				end_of_sim_ = true;
 			}
@@ -804,7 +1065,30 @@ class engine
 	}
 
 
+	/// Immediately (schedule and) fire an event from the given source.
 	protected: void fire_immediate_event(event_source_pointer const& ptr_src, engine_context_type& ctx)
+	{
+		fire_immediate_event<with_event_firing_hooks>(ptr_src, ctx);
+	}
+
+
+	/// Immediately (schedule and) fire an event with the given state from the
+	/// given source.
+	protected: template <typename T>
+		void fire_immediate_event(event_source_pointer const& ptr_src, engine_context_type& ctx, T const& state)
+	{
+		fire_immediate_event<with_event_firing_hooks>(ptr_src, ctx, state);
+	}
+
+
+	/**
+	 * \brief Immediately (schedule and) fire an event from the given source.
+	 *
+	 * \tparam FiringHooksT The policy for the BEFORE/AFTER-EVENT-FIRING events
+	 *  (see \c with_event_firing_hooks and \c without_event_firing_hooks).
+	 */
+	protected: template <typename FiringHooksT>
+		void fire_immediate_event(event_source_pointer const& ptr_src, engine_context_type& ctx)
 	{
 		event_type cur_evt(ptr_src, sim_time_, sim_time_);
 
@@ -823,8 +1107,14 @@ class engine
 
 		DCS_DEBUG_TRACE_L(1, "Firing (immediate) EVENT #" << num_events_ << ": " << cur_evt );
 
+		// Notify the before-event-firing observers
+		if (FiringHooksT::enabled && !ptr_bef_obs_->empty())
+		{
+			ptr_bef_obs_->emit(cur_evt, ctx);
+		}
+
 		// Firing the before-event-firing event
-		if (!ptr_bef_evt_src_->empty())
+		if (FiringHooksT::enabled && !ptr_bef_evt_src_->empty())
 		{
 			make_internal_event(ptr_bef_evt_src_, cur_evt).fire(ctx);
 			++num_events_;
@@ -832,8 +1122,14 @@ class engine
 
 		cur_evt.fire(ctx);
 
+		// Notify the after-event-firing observers
+		if (FiringHooksT::enabled && !ptr_aef_obs_->empty())
+		{
+			ptr_aef_obs_->emit(cur_evt, ctx);
+		}
+
 		// Firing the after-event-firing event
-		if (!ptr_aef_evt_src_->empty())
+		if (FiringHooksT::enabled && !ptr_aef_evt_src_->empty())
 		{
 			make_internal_event(ptr_aef_evt_src_, cur_evt).fire(ctx);
 			++num_events_;
@@ -849,7 +1145,14 @@ class engine
 	}
 
 
-	protected: template <typename T>
+	/**
+	 * \brief Immediately (schedule and) fire an event with the given state from
+	 *  the given source.
+	 *
+	 * \tparam FiringHooksT The policy for the BEFORE/AFTER-EVENT-FIRING events
+	 *  (see \c with_event_firing_hooks and \c without_event_firing_hooks).
+	 */
+	protected: template <typename FiringHooksT, typename T>
 		void fire_immediate_event(event_source_pointer const& ptr_src, engine_context_type& ctx, T const& state)
 	{
 		event_type cur_evt(ptr_src, sim_time_, sim_time_, state);
@@ -869,8 +1172,14 @@ class engine
 
 		DCS_DEBUG_TRACE_L(1, "Firing (immediate) EVENT #" << num_events_ << ": " << cur_evt );
 
+		// Notify the before-event-firing observers
+		if (FiringHooksT::enabled && !ptr_bef_obs_->empty())
+		{
+			ptr_bef_obs_->emit(cur_evt, ctx);
+		}
+
 		// Firing the before-event-firing event
-		if (!ptr_bef_evt_src_->empty())
+		if (FiringHooksT::enabled && !ptr_bef_evt_src_->empty())
 		{
 			make_internal_event(ptr_bef_evt_src_, cur_evt).fire(ctx);
 			++num_events_;
@@ -878,8 +1187,14 @@ class engine
 
 		cur_evt.fire(ctx);
 
+		// Notify the after-event-firing observers
+		if (FiringHooksT::enabled && !ptr_aef_obs_->empty())
+		{
+			ptr_aef_obs_->emit(cur_evt, ctx);
+		}
+
 		// Firing the after-event-firing event
-		if (!ptr_aef_evt_src_->empty())
+		if (FiringHooksT::enabled && !ptr_aef_evt_src_->empty())
 		{
 			make_internal_event(ptr_aef_evt_src_, cur_evt).fire(ctx);
 			++num_events_;
@@ -934,35 +1249,33 @@ class engine
 			return;
 		}
 
-
-		bool prec_reached(true);
-		analyzable_statistic_iterator end_it(mon_stats_.end());
-		for (
-			analyzable_statistic_iterator it = mon_stats_.begin();
-			it != end_it;
-			++it
-		) {
-			analyzable_statistic_pointer ptr_stat(it->first);
-
-			DCS_DEBUG_TRACE_L(1,"Stat " << ptr_stat.get() << ">> Checking for precision -- reached: " << ptr_stat->relative_precision() << ", wanted: " << ptr_stat->target_relative_precision());
-
-			if (!it->second && ptr_stat->steady_state_entered())
-			{
-				it->second = true;
-				ptr_stat->steady_state_enter_time(sim_time_);
+		// Set the steady-state enter time of the statistics which have just
+		// entered their steady state.
+		// Statistics notify this engine when their state changes, so this loop
+		// is only performed after such a change.
+		if (num_new_steady_stats_ > 0)
+		{
+			analyzable_statistic_iterator end_it(mon_stats_.end());
+			for (
+				analyzable_statistic_iterator it = mon_stats_.begin();
+				it != end_it;
+				++it
+			) {
+				analyzable_statistic_pointer ptr_stat(it->first);
+
+				if (!it->second && ptr_stat->steady_state_entered())
+				{
+					it->second = true;
+					ptr_stat->steady_state_enter_time(sim_time_);
+				}
 			}
 
-			// Check if precision has been reached.
-			if (ptr_stat->enabled() && !ptr_stat->target_precision_reached())
-			{
-				DCS_DEBUG_TRACE_L(1,"Target precision NOT reached.");
-				prec_reached = false;
-				//break; //NO! We must loop for every stat since we also set the steady-state enter time (see above)
-			}
+			num_new_steady_stats_ = 0;
 		}
 
-
-		if (prec_reached)
+		// Check if precision has been reached for all statistics (or possibly
+		// some of them are disabled).
+		if (num_unsatisfied_stats_ == 0)
 		{
 			DCS_DEBUG_TRACE_L(1,"Target precision reached for all statistics (or possibly some of them are disabled).");
 
@@ -983,12 +1296,112 @@ class engine
 	}
 
 
+	/**
+	 * \brief Return the monitored statistics whose state may change as the
+	 *  simulated time advances (see
+	 *  \c base_analyzable_statistic::time_dependent).
+	 */
+	protected: time_dependent_statistic_container const& time_dependent_statistics() const
+	{
+		return time_dep_stats_;
+	}
+
+
+	/**
+	 * \brief Return the number of monitored statistics which have neither
+	 *  collected the observations needed by the current experiment nor been
+	 *  disabled.
+	 *
+	 * The counter is kept from the completion notifications of the statistics,
+	 * which are only sent by the output analysis methods relying on it (e.g.,
+	 * independent replications).
+	 */
+	protected: size_type num_incomplete_statistics() const
+	{
+		return num_incomplete_stats_;
+	}
+
+
 	protected: event_list<event_type>& future_event_list()
 	{
 		return evt_list_;
 	}
 
 
+	/// Stop listening to the given statistic.
+	private: void detach_statistic(analyzable_statistic_pointer const& ptr_stat)
+	{
+		// Read the cached state the counters were kept from before detaching,
+		// since setting the listener brings such state up-to-date.
+		bool satisfied(ptr_stat->precision_satisfied());
+		bool complete(ptr_stat->completion_satisfied());
+
+		if (ptr_stat->listener() == static_cast<analyzable_statistic_listener_type*>(this))
+		{
+			ptr_stat->listener(0);
+		}
+		if (!satisfied)
+		{
+			DCS_DEBUG_ASSERT( num_unsatisfied_stats_ > 0 );
+
+			--num_unsatisfied_stats_;
+		}
+		if (!complete)
+		{
+			DCS_DEBUG_ASSERT( num_incomplete_stats_ > 0 );
+
+			--num_incomplete_stats_;
+		}
+		if (ptr_stat->time_dependent())
+		{
+			time_dep_stats_.erase(::std::remove(time_dep_stats_.begin(), time_dep_stats_.end(), ptr_stat), time_dep_stats_.end());
+		}
+	}
+
+
+	private: void precision_state_changed(analyzable_statistic_type& stat, bool satisfied)
+	{
+		DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING(stat);
+
+		DCS_DEBUG_TRACE_L(1,"Stat " << &stat << ">> Precision state changed -- reached: " << stat.relative_precision() << ", wanted: " << stat.target_relative_precision() << ", enabled: " << stat.enabled());
+
+		if (satisfied)
+		{
+			--num_unsatisfied_stats_;
+		}
+		else
+		{
+			++num_unsatisfied_stats_;
+		}
+	}
+
+
+	private: void steady_state_changed(analyzable_statistic_type& stat, bool entered)
+	{
+		DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING(stat);
+
+		if (entered)
+		{
+			++num_new_steady_stats_;
+		}
+	}
+
+
+	private: void completion_state_changed(analyzable_statistic_type& stat, bool satisfied)
+	{
+		DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING(stat);
+
+		if (satisfied)
+		{
+			--num_incomplete_stats_;
+		}
+		else
+		{
+			++num_incomplete_stats_;
+		}
+	}
+
+
 	protected: event_list<event_type> const& future_event_list() const
 	{
 		return evt_list_;
@@ -1013,6 +1426,26 @@ class engine
 	}
 
 
+	/**
+	 * \brief Insert the given event in the event list.
+	 *
+	 * Zero-delay events (i.e., events to be fired at the current simulated
+	 * time) go to the FIFO lane of immediate events, thus bypassing the
+	 * ordering work of the event container.
+	 */
+	private: void enqueue_event(event_pointer const& ptr_evt)
+	{
+		if (ptr_evt->fire_time() == sim_time_)
+		{
+			evt_list_.push_immediate(ptr_evt);
+		}
+		else
+		{
+			evt_list_.push(ptr_evt);
+		}
+	}
+
+
 	protected: event_type make_internal_event(event_source_pointer const& ptr_evt_src, event_type const& embedded_evt)
 	{
 		return event_type(ptr_evt_src, sim_time_, sim_time_, embedded_evt);
@@ -1046,6 +1479,8 @@ class engine
 
 	/// The event list.
 	private: event_list<event_type> evt_list_;
+	/// The memory pool for scheduled events (shared with the event allocators).
+	private: ::boost::shared_ptr<detail::fixed_size_pool> ptr_evt_pool_;
 	/// The source of the begin-of-simulation event
 	private: event_source_pointer ptr_bos_evt_src_;
 	/// The source of the end-of-simulation event
@@ -1058,6 +1493,10 @@ class engine
 	private: event_source_pointer ptr_si_evt_src_;
 	/// The source of the system-finalization event
 	private: event_source_pointer ptr_sf_evt_src_;
+	/// The before-event-firing observers
+	private: observer_list_pointer ptr_bef_obs_;
+	/// The after-event-firing observers
+	private: observer_list_pointer ptr_aef_obs_;
 	/// The simulated time (does not include pause time).
 	private: real_type sim_time_;
 	/// The time of the last fired event.
@@ -1071,6 +1510,18 @@ class engine
 	/// itself).
 	private: size_type num_usr_events_;
 	private: analyzable_statistic_container mon_stats_;
+	/// The number of monitored statistics which have neither reached their
+	/// target precision nor been disabled.
+	private: size_type num_unsatisfied_stats_;
+	/// The number of monitored statistics which have entered their steady
+	/// state since the last check.
+	private: size_type num_new_steady_stats_;
+	/// The number of monitored statistics which have neither collected the
+	/// observations needed by the current experiment nor been disabled.
+	private: size_type num_incomplete_stats_;
+	/// The monitored statistics whose state may change with the simulated
+	/// time.
+	private: time_dependent_statistic_container time_dep_stats_;
 	//private: analyzable_statistic_pointer ptr_mon_stat_;
 
 	//@} Member variables
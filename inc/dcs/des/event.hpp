@@ -30,11 +30,12 @@
 
 
 #include <dcs/des/event_source.hpp>
+#include <dcs/des/event_state.hpp>
 #include <dcs/des/fwd.hpp>
 #include <boost/smart_ptr.hpp>
+#include <cstddef>
 #include <dcs/type_traits/add_const.hpp>
 #include <dcs/type_traits/add_reference.hpp>
-#include <dcs/util/any.hpp>
 #include <iostream>
 #include <string>
 
@@ -59,7 +60,8 @@ class event
 	public: typedef RealT real_type;
 	public: typedef event_source<real_type> event_source_type;
 	public: typedef engine_context<real_type> engine_context_type;
-	public: typedef ::dcs::util::any state_type;
+	//public: typedef ::dcs::util::any state_type;
+	public: typedef event_state state_type;
 
 
 	//FIXME: let the creator of the event decide what ID to assigne
@@ -77,7 +79,10 @@ class event
 		  sched_time_(sched_time),
 		  fire_time_(fire_time),
 		  state_(state),
-		  id_(next_id++)
+		  id_(next_id++),
+		  list_pos_(static_cast< ::std::size_t >(-1)),
+		  scheduled_(false),
+		  internal_(ptr_src && ptr_src->internal())
 	{
 		// empty
 	}
@@ -90,8 +95,11 @@ class event
 	  sched_time_(that.sched_time_),
 	  fire_time_(that.fire_time_),
 	  state_(that.state_),
-	  id_(that.id_)
+	  id_(that.id_),
 	  //id_(next_id++)
+	  list_pos_(static_cast< ::std::size_t >(-1)), // a copy is not in the event list
+	  scheduled_(false),
+	  internal_(that.internal_)
 	{
 		// FIXME: What to do with id_?
 	}
@@ -108,6 +116,7 @@ class event
 			fire_time_ = rhs.fire_time_;
 			state_ = rhs.state_;
 			id_ = rhs.id_;
+			internal_ = rhs.internal_;
 		}
 
 		return *this;
@@ -150,6 +159,46 @@ class event
 	}
 
 
+	/// Tell if this event is currently inside the future event list.
+	public: bool scheduled() const
+	{
+		return scheduled_;
+	}
+
+
+	/// Set whether this event is currently inside the future event list.
+	public: void scheduled(bool value)
+	{
+		scheduled_ = value;
+	}
+
+
+	/**
+	 * \brief Tell if this is an engine-internal event.
+	 *
+	 * The flag is taken from the event source when the event is created, so
+	 * that the engine can classify events without looking at their source.
+	 */
+	public: bool internal() const
+	{
+		return internal_;
+	}
+
+
+	/// Return the position of this event inside the future event list.
+	public: ::std::size_t list_position() const
+	{
+		return list_pos_;
+	}
+
+
+	/// Set the position of this event inside the future event list.
+	public: void list_position(::std::size_t pos)
+	{
+		list_pos_ = pos;
+	}
+
+
 	public: void fire(engine_context_type& ctx)
 	{
 		ptr_src_->emit(*this, ctx);
@@ -173,7 +222,8 @@ class event
 	{
 		typedef typename ::dcs::type_traits::add_reference<T>::type ref_type;
 
-		return ::dcs::util::any_cast<ref_type>(state_);
+		//return ::dcs::util::any_cast<ref_type>(state_);
+		return event_state_cast<ref_type>(state_);
 	}
 
 
@@ -185,7 +235,8 @@ class event
 					typename ::dcs::type_traits::add_const<T>::type
 				>::type const_ref_type;
 
-		return ::dcs::util::any_cast<const_ref_type>(state_);
+		//return ::dcs::util::any_cast<const_ref_type>(state_);
+		return event_state_cast<const_ref_type>(state_);
 /*
 		return ::dcs::util::any_cast<double>(state_);
 */
@@ -204,6 +255,12 @@ class event
 	private: state_type state_;
 	/// The event identifier
 	private: unsigned long id_;
+	/// The position inside the future event list (used by indexed lists).
+	private: ::std::size_t list_pos_;
+	/// Tell if this event is inside the future event list.
+	private: bool scheduled_;
+	/// Tell if this is an engine-internal event.
+	private: bool internal_;
 
 	//@} Member variables
 };
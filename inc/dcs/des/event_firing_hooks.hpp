@@ -0,0 +1,67 @@
+/**
+ * \file dcs/des/event_firing_hooks.hpp
+ *
+ * \brief Policies for the BEFORE/AFTER-EVENT-FIRING hooks of simulation
+ *  engines.
+ *
+ * Copyright (C) 2012       Distributed Computing System (DCS) Group,
+ *                          Computer Science Institute,
+ *                          Department of Science and Technological Innovation,
+ *                          University of Piemonte Orientale,
+ *                          Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_EVENT_FIRING_HOOKS_HPP
+#define DCS_DES_EVENT_FIRING_HOOKS_HPP
+
+
+namespace dcs { namespace des {
+
+/**
+ * \brief Policy enabling the BEFORE-EVENT-FIRING and AFTER-EVENT-FIRING
+ *  events.
+ *
+ * The simulation engine fires these events around each event, as long as some
+ * event sink is connected to the related event source.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+struct with_event_firing_hooks
+{
+	static const bool enabled = true;
+};
+
+
+/**
+ * \brief Policy disabling the BEFORE-EVENT-FIRING and AFTER-EVENT-FIRING
+ *  events.
+ *
+ * The code related to these events is compiled away from the engine run loop;
+ * event sinks connected to the related event sources are never invoked.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+struct without_event_firing_hooks
+{
+	static const bool enabled = false;
+};
+
+}} // Namespace dcs::des
+
+
+#endif // DCS_DES_EVENT_FIRING_HOOKS_HPP
@@ -30,15 +30,34 @@
 
 
 #include <algorithm>
+#include <boost/iterator/iterator_facade.hpp>
 #include <boost/smart_ptr.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/unordered_map.hpp>
+#include <cmath>
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/debug.hpp>
+#include <dcs/macro.hpp>
 #include <functional>
+#include <iostream>
 #include <list>
 #include <queue>
+#include <stdexcept>
 #include <vector>
 
 
 namespace dcs { namespace des {
 
+/// Policies for removing (i.e., cancelling or rescheduling) events from the
+/// future event list.
+enum event_removal_policy
+{
+	eager_event_removal, ///< Events are taken out of the event container at once.
+	lazy_event_removal ///< Events are only marked as dead and purged later on (see \c detail::lazy_heap).
+};
+
+
 namespace detail { namespace /*<unnamed>*/ {
 
 /**
@@ -138,6 +157,13 @@ class ordered_list
 	}
 
 
+	/// Removes all the elements from the list.
+	public: void clear()
+	{
+		list_.clear();
+	}
+
+
 	/// Return \c true if the list is empty; \c false otherwise.
 	public: bool empty() const
 	{
@@ -183,188 +209,2010 @@ class ordered_list
 };
 
 
-template <typename PtrEventT>
-struct less: public ::std::binary_function<PtrEventT, PtrEventT, bool>
+/**
+ * \brief Back-index of a d-ary heap based on a hash table.
+ *
+ * Map each element to its position inside the heap by means of a hash table.
+ * Elements must be unique (w.r.t. equality) and hashable.
+ *
+ * \tparam T The element type.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename T>
+class hashed_heap_index
 {
-	bool operator()(PtrEventT const& x, PtrEventT const& y) const
+	private: typedef ::boost::unordered_map<T,::std::size_t> index_impl_type;
+	public: typedef T value_type;
+	public: typedef ::std::size_t size_type;
+
+
+	public: static const size_type npos = static_cast<size_type>(-1);
+
+
+	/// Return the position of the given element or \c npos if not found.
+	public: size_type find(value_type const& x) const
 	{
-		return (*x) < (*y);
+		typename index_impl_type::const_iterator it(index_.find(x));
+
+		return (it != index_.end()) ? it->second : npos;
+	}
+
+
+	/// Record the position of the given element.
+	public: void update(value_type const& x, size_type pos)
+	{
+		index_[x] = pos;
+	}
+
+
+	/// Forget the position of the given element.
+	public: void remove(value_type const& x)
+	{
+		index_.erase(x);
+	}
+
+
+	/// Forget the position of all elements.
+	public: void clear()
+	{
+		index_.clear();
 	}
+
+
+	private: index_impl_type index_;
 };
 
+template <typename T>
+const typename hashed_heap_index<T>::size_type hashed_heap_index<T>::npos;
 
+
+/**
+ * \brief Back-index of a d-ary heap stored inside the events.
+ *
+ * Store the position of each (pointer to) event inside the heap into the event
+ * itself (see \c event::list_position), thus avoiding any lookup.
+ *
+ * \tparam PtrEventT The type of the pointer to the event.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
 template <typename PtrEventT>
-struct less_equal: public ::std::binary_function<PtrEventT, PtrEventT, bool>
+struct intrusive_heap_index
 {
-	bool operator()(PtrEventT const& x, PtrEventT const& y) const
+	typedef PtrEventT value_type;
+	typedef ::std::size_t size_type;
+
+
+	static const size_type npos = static_cast<size_type>(-1);
+
+
+	/// Return the position of the given event or \c npos if not found.
+	size_type find(value_type const& x) const
 	{
-		return (*x) <= (*y);
+		return x->list_position();
+	}
+
+
+	/// Record the position of the given event.
+	void update(value_type const& x, size_type pos)
+	{
+		x->list_position(pos);
+	}
+
+
+	/// Forget the position of the given event.
+	void remove(value_type const& x)
+	{
+		x->list_position(npos);
+	}
+
+
+	/// Forget the position of all events.
+	void clear()
+	{
+		// empty: positions of stale events are checked by the heap
 	}
 };
 
-}}// Namespace detail::<unnamed>
+template <typename PtrEventT>
+const typename intrusive_heap_index<PtrEventT>::size_type intrusive_heap_index<PtrEventT>::npos;
+
 
 /**
- * \brief Base event-list.
+ * \brief Indexed d-ary heap.
  *
- * \tparam EventT The event type.
- * \tparam SequenceT The event container type (default to priority-queue).
+ * A d-ary min-heap (w.r.t. the order defined by the comparator) stored in a
+ * contiguous array.
+ * Elements comparing equal are extracted in insertion order (i.e., FIFO order)
+ * by breaking ties with an insertion sequence number.
+ * A back-index maps each element to its current position inside the heap, so
+ * that an arbitrary element can be erased in \f$O(\log_d n)\f$ time.
+ * By default, the back-index is a hash table (see \c hashed_heap_index); for
+ * (pointers to) events, the position can be stored inside the event itself
+ * (see \c intrusive_heap_index).
+ *
+ * Iteration (through \c begin and \c end) visits the elements in heap order,
+ * which, in general, is not the sorted order.
+ *
+ * \note Elements must be unique (w.r.t. equality).
+ *
+ * \tparam T The element type.
+ * \tparam ComparatorT The element comparator.
+ * \tparam Arity The number of children of each heap node (must be >= 2).
+ * \tparam IndexT The back-index type.
  *
- * \author Cosimo Anglano, &lt;cosimo.anglano@mfn.unipmn.it&gt;
  * \author Marco Guazzone (marco.guazzone@gmail.com)
  */
 template <
-	typename EventT,
-	//typename SequenceT=::std::priority_queue< EventT, ::std::vector<EventT>, ::std::greater<EventT> > // std::priority_queue by default returns the greater element
-	//typename SequenceT=detail::ordered_list<EventT, ::std::less<EventT> >
-	typename SequenceT=detail::ordered_list< ::boost::shared_ptr<EventT>, detail::less< ::boost::shared_ptr<EventT> > >//[sguazt] EXP
+	typename T,
+	typename ComparatorT=::std::less<T>,
+	::std::size_t Arity=4,
+	typename IndexT=hashed_heap_index<T>
 >
-class event_list
+class d_ary_heap
 {
-	/// The type of the value hold by this container.
-	public: typedef typename SequenceT::value_type value_type;
-	/// The type of the reference to the value hold by this container.
-	public: typedef typename SequenceT::reference reference;
-	/// The type of the constant reference to the value hold by this container.
-	public: typedef typename SequenceT::const_reference const_reference;
-	/// The type of the size of this container.
-	public: typedef typename SequenceT::size_type size_type;
-	/// The type of the internal container.
-	public: typedef SequenceT container_type;
+	private: typedef ::std::vector<T> heap_impl_type;
+	public: typedef T value_type;
+	public: typedef ComparatorT comparator_type;
+	public: typedef typename heap_impl_type::const_pointer pointer;
+	public: typedef typename heap_impl_type::const_pointer const_pointer;
+	public: typedef typename heap_impl_type::const_reference reference;
+	public: typedef typename heap_impl_type::const_reference const_reference;
+	public: typedef typename heap_impl_type::const_iterator iterator;
+	public: typedef typename heap_impl_type::const_iterator const_iterator;
+	public: typedef typename heap_impl_type::size_type size_type;
+	public: typedef typename heap_impl_type::difference_type difference_type;
+	public: typedef typename heap_impl_type::allocator_type allocator_type;
+	private: typedef unsigned long sequence_type;
+	private: typedef IndexT index_type;
 
 
-	// compiler generated default/copy ctor and copy assignement are fine
+	BOOST_STATIC_ASSERT( Arity >= 2 );
 
 
-	//@{ Public member functions
+	public: d_ary_heap()
+	: next_seq_(0)
+	{
+		// empty
+	}
 
-	/**
-	 * \brief Insert a new event in the list.
-	 * \param ptr_evt The (pointer to an) event to be inserted.
-	 */
-	public: void push(value_type const& evt)
+
+	public: template <typename ForwardIterT>
+		d_ary_heap(ForwardIterT first, ForwardIterT last)
+	: next_seq_(0)
 	{
-		seq_.push(evt);
+		while (first != last)
+		{
+			push(*first);
+			++first;
+		}
 	}
 
 
-	/**
-	 * \brief Extract the next event from the list.
-	 */
+	/// Insert the given element (w.r.t- the order defined by the comparator).
+	public: void push(value_type const& x)
+	{
+		heap_.push_back(x);
+		seqs_.push_back(next_seq_++);
+		index_.update(x, heap_.size()-1);
+
+		sift_up(heap_.size()-1);
+	}
+
+
+	/// Remove the minimum element (w.r.t. the order defined by the comparator).
 	public: void pop()
 	{
-		seq_.pop();
+		remove_at(0);
+	}
+
+
+	/// Return the minimum element (w.r.t. the order defined by the comparator).
+	public: value_type const& top() const
+	{
+		return heap_.front();
+	}
+
+
+	/// Removes from the heap the element located at the given position.
+	public: iterator erase(iterator pos)
+	{
+		size_type i(pos-heap_.begin());
+
+		remove_at(i);
+
+		return heap_.begin()+i;
 	}
 
 
 	/**
-	 * \brief Tell if the list is empty (i.e., with no event).
-	 * \return \c true if there no event inside the list; \c false otherwise.
+	 * \brief Removes from the heap the given element.
+	 * \return \c true if the element has been found and removed; \c false
+	 *  otherwise.
 	 */
+	public: bool erase(value_type const& x)
+	{
+		size_type pos(index_.find(x));
+
+		// Check for stale positions
+		if (pos >= heap_.size() || !(heap_[pos] == x))
+		{
+			return false;
+		}
+
+		remove_at(pos);
+
+		return true;
+	}
+
+
+	/// Removes all the elements from the heap.
+	public: void clear()
+	{
+		heap_.clear();
+		seqs_.clear();
+		index_.clear();
+	}
+
+
+	/// Return \c true if the heap is empty; \c false otherwise.
 	public: bool empty() const
 	{
-		return seq_.empty();
+		return heap_.empty();
 	}
 
 
-	/**
-	 * \brief Return the number of events inside the list.
-	 * \return The number of events inside the list.
-	 */
+	/// Return the current size of the heap.
 	public: size_type size() const
 	{
-		return seq_.size();
+		return heap_.size();
 	}
 
 
-	/**
-	 * \brief Return the next event from the list (without extracting it).
-	 * \return The next event.
-	 */
-	public: const_reference top() const
+	public: const_iterator begin() const
 	{
-		return seq_.top();
+		return heap_.begin();
 	}
 
 
-	/**
-	 * \brief Clear the list.
-	 */
-	public: void clear()
+	public: const_iterator end() const
+	{
+		return heap_.end();
+	}
+
+
+	/// Tell if the element at position \a i must precede the one at \a j.
+	private: bool precedes(size_type i, size_type j) const
 	{
-		while (!seq_.empty())
+		if (cmp_(heap_[i], heap_[j]))
 		{
-			seq_.pop();
+			return true;
+		}
+		if (cmp_(heap_[j], heap_[i]))
+		{
+			return false;
 		}
+		// Equivalent elements: keep insertion order
+		return seqs_[i] < seqs_[j];
 	}
 
 
-	public: void erase(value_type const& evt)
+	private: void swap_at(size_type i, size_type j)
 	{
-		//seq_.erase(::std::find(seq_.begin(), seq_.end(), evt));
+		::std::swap(heap_[i], heap_[j]);
+		::std::swap(seqs_[i], seqs_[j]);
+		index_.update(heap_[i], i);
+		index_.update(heap_[j], j);
+	}
 
-		typedef typename container_type::iterator iterator;
 
-		iterator end_it(seq_.end());
-		// Find the position of the first "equivalent" event.
-		// Note: Two events are equivalent if they are concurrent.
-		iterator it(::std::find(seq_.begin(), end_it, evt));
-		// Make sure to erase the exact event by checking for its ID
-		while (it != end_it && (*it)->id() != evt->id())
+	private: void sift_up(size_type i)
+	{
+		while (i > 0)
 		{
-			++it;
+			size_type p((i-1)/Arity);
+
+			if (!precedes(i, p))
+			{
+				break;
+			}
+
+			swap_at(i, p);
+			i = p;
 		}
-		if (it != end_it)
+	}
+
+
+	private: void sift_down(size_type i)
+	{
+		const size_type n(heap_.size());
+
+		while (true)
 		{
-			seq_.erase(it);
+			size_type first_child(i*Arity+1);
+
+			if (first_child >= n)
+			{
+				break;
+			}
+
+			size_type last_child(::std::min(first_child+Arity, n));
+			size_type best(first_child);
+			for (size_type c = first_child+1; c < last_child; ++c)
+			{
+				if (precedes(c, best))
+				{
+					best = c;
+				}
+			}
+
+			if (!precedes(best, i))
+			{
+				break;
+			}
+
+			swap_at(i, best);
+			i = best;
 		}
-		else
+	}
+
+
+	private: void remove_at(size_type i)
+	{
+		const size_type last(heap_.size()-1);
+
+		index_.remove(heap_[i]);
+
+		if (i != last)
 		{
-			::std::clog << "[Warning] Event " << *evt << " not removed because it has not been found." << ::std::endl;
+			heap_[i] = heap_[last];
+			seqs_[i] = seqs_[last];
+			index_.update(heap_[i], i);
+		}
+
+		heap_.pop_back();
+		seqs_.pop_back();
+
+		if (i < heap_.size())
+		{
+			if (i > 0 && precedes(i, (i-1)/Arity))
+			{
+				sift_up(i);
+			}
+			else
+			{
+				sift_down(i);
+			}
 		}
 	}
 
 
-//	public: void erase(iterator pos)
-//	{
-//		seq_.erase(pos);
-//	}
+	/// The heap-ordered elements.
+	private: heap_impl_type heap_;
+	/// The insertion sequence numbers (parallel to \c heap_).
+	private: ::std::vector<sequence_type> seqs_;
+	/// The back-index mapping each element to its position inside the heap.
+	private: index_type index_;
+	/// The next insertion sequence number.
+	private: sequence_type next_seq_;
+	/// The element comparator.
+	private: comparator_type cmp_;
+};
 
 
-//	public: void erase(iterator first, iterator last)
-//	{
-//		seq_.erase(first, last);
-//	}
+/// Remove the given element from a generic sequence (linear search).
+template <typename SequenceT, typename T>
+bool erase_element(SequenceT& seq, T const& x)
+{
+	typedef typename SequenceT::iterator iterator;
+
+	iterator end_it(seq.end());
+	// Find the position of the first "equivalent" event.
+	// Note: Two events are equivalent if they are concurrent.
+	iterator it(::std::find(seq.begin(), end_it, x));
+	// Make sure to erase the exact event by checking for its ID
+	while (it != end_it && (*it)->id() != x->id())
+	{
+		++it;
+	}
+	if (it != end_it)
+	{
+		seq.erase(it);
+		return true;
+	}
 
+	return false;
+}
 
-//	public: void touch(value_type const& evt)
-//	{
-//		typedef typename container_type::iterator iterator;
-//
-////		iterator it(seq_.begin());
-////		iterator end_it(seq_.end());
-////		while (it != end_it && *it != evt)
-////		{
-////			++it;
-////		}
-//
-//		iterator end_it(seq_.end());
-//		iterator it(::std::find(seq_.begin(), end_it, evt));
-//
-//		if (it != end_it)
-//		{
-//			seq_.erase(it);
-//			push(evt);
-//		}
-//	}
+
+/// Remove the given element from an indexed d-ary heap (back-index lookup).
+template <typename T, typename ComparatorT, ::std::size_t Arity, typename IndexT>
+bool erase_element(d_ary_heap<T,ComparatorT,Arity,IndexT>& seq, T const& x)
+{
+	return seq.erase(x);
+}
 
 
-	//@} Public member functions
+template <typename PtrEventT>
+struct less: public ::std::binary_function<PtrEventT, PtrEventT, bool>
+{
+	bool operator()(PtrEventT const& x, PtrEventT const& y) const
+	{
+		return (*x) < (*y);
+	}
+};
+
+
+template <typename PtrEventT>
+struct less_equal: public ::std::binary_function<PtrEventT, PtrEventT, bool>
+{
+	bool operator()(PtrEventT const& x, PtrEventT const& y) const
+	{
+		return (*x) <= (*y);
+	}
+};
+
+
+/// Extract the fire time from a pointer to an event.
+template <typename PtrEventT>
+struct fire_time_key
+{
+	typedef typename PtrEventT::element_type::real_type result_type;
+
+	result_type operator()(PtrEventT const& x) const
+	{
+		return x->fire_time();
+	}
+};
+
+
+/**
+ * \brief Calendar queue.
+ *
+ * Implementation of the calendar queue by (Brown,1988).
+ * Elements are hashed by their key into an array of buckets (the "days" of
+ * a "year"); each bucket is kept sorted by key.
+ * The minimum element is found by visiting the buckets in cyclic order, from
+ * the day of the last extracted element.
+ * The number of buckets is doubled (halved) when the number of elements
+ * becomes greater than twice (less than half) the number of buckets; on each
+ * resize, the bucket width is recomputed from the average separation of the
+ * smallest keys.
+ * This gives \f$O(1)\f$ amortized \c push and \c pop under the key
+ * distributions usually found in discrete-event simulation.
+ *
+ * Elements with equal keys are extracted in insertion order (i.e., FIFO order)
+ * by breaking ties with an insertion sequence number; this order is preserved
+ * across resizes.
+ *
+ * Iteration (through \c begin and \c end) visits the elements bucket by
+ * bucket, which, in general, is not the sorted order.
+ *
+ * \tparam T The element type.
+ * \tparam KeyT The functor extracting the (real-valued) key from an element.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * References:
+ * -# R. Brown,
+ *    "Calendar Queues: A Fast O(1) Priority Queue Implementation for the
+ *     Simulation Event Set Problem,"
+ *    Communications of the ACM 31(10):1220-1227, 1988.
+ * .
+ */
+template <
+	typename T,
+	typename KeyT=fire_time_key<T>
+>
+class calendar_queue
+{
+	private: typedef calendar_queue<T,KeyT> self_type;
+	public: typedef T value_type;
+	public: typedef KeyT key_extractor_type;
+	public: typedef typename KeyT::result_type key_type;
+	public: typedef value_type const* pointer;
+	public: typedef value_type const* const_pointer;
+	public: typedef value_type const& reference;
+	public: typedef value_type const& const_reference;
+	public: typedef ::std::size_t size_type;
+	public: typedef ::std::ptrdiff_t difference_type;
+	private: typedef unsigned long sequence_type;
+	private: struct node
+	{
+		node(value_type const& v, key_type k, sequence_type s)
+		: value(v), key(k), seq(s)
+		{
+		}
+
+		value_type value;
+		key_type key;
+		sequence_type seq;
+	};
+	private: struct node_less
+	{
+		bool operator()(node const& x, node const& y) const
+		{
+			return x.key < y.key || (!(y.key < x.key) && x.seq < y.seq);
+		}
+	};
+	private: typedef ::std::vector<node> bucket_type;
+	private: typedef ::std::vector<bucket_type> bucket_container;
+
+
+	/// Constant iterator over the elements of a calendar queue.
+	public: class const_iterator: public ::boost::iterator_facade<const_iterator,
+																	value_type const,
+																	::boost::forward_traversal_tag>
+	{
+		friend class ::boost::iterator_core_access;
+		friend class calendar_queue;
+
+
+		public: const_iterator()
+		: ptr_buckets_(0),
+		  b_(0),
+		  i_(0)
+		{
+		}
+
+
+		private: const_iterator(bucket_container const* ptr_buckets, size_type b, size_type i)
+		: ptr_buckets_(ptr_buckets),
+		  b_(b),
+		  i_(i)
+		{
+			skip_empty();
+		}
+
+
+		private: void skip_empty()
+		{
+			while (b_ < ptr_buckets_->size() && i_ >= (*ptr_buckets_)[b_].size())
+			{
+				++b_;
+				i_ = 0;
+			}
+		}
+
+
+		private: void increment()
+		{
+			++i_;
+			skip_empty();
+		}
+
+
+		private: bool equal(const_iterator const& other) const
+		{
+			return b_ == other.b_ && i_ == other.i_;
+		}
+
+
+		private: value_type const& dereference() const
+		{
+			return (*ptr_buckets_)[b_][i_].value;
+		}
+
+
+		private: bucket_container const* ptr_buckets_;
+		private: size_type b_;
+		private: size_type i_;
+	};
+	public: typedef const_iterator iterator;
+
+
+	private: static const size_type min_num_buckets = 2;
+	private: static const size_type num_width_samples = 25;
+
+
+	public: explicit calendar_queue(key_type width=key_type(1))
+	: buckets_(min_num_buckets),
+	  width_(width),
+	  size_(0),
+	  next_seq_(0),
+	  cur_day_(0)
+	{
+		// empty
+	}
+
+
+	public: template <typename ForwardIterT>
+		calendar_queue(ForwardIterT first, ForwardIterT last)
+	: buckets_(min_num_buckets),
+	  width_(1),
+	  size_(0),
+	  next_seq_(0),
+	  cur_day_(0)
+	{
+		while (first != last)
+		{
+			push(*first);
+			++first;
+		}
+	}
+
+
+	/// Insert the given element (w.r.t- the order defined by the key).
+	public: void push(value_type const& x)
+	{
+		node n(x, key_(x), next_seq_++);
+
+		key_type day(day_of(n.key));
+		bucket_type& bucket(buckets_[bucket_of(day)]);
+		bucket.insert(::std::upper_bound(bucket.begin(), bucket.end(), n, node_less()), n);
+		++size_;
+
+		// Events in the past w.r.t. the current day restart the search from
+		// their own day
+		if (day < cur_day_)
+		{
+			cur_day_ = day;
+		}
+
+		if (size_ > 2*buckets_.size())
+		{
+			resize(2*buckets_.size());
+		}
+	}
+
+
+	/// Remove the minimum element (w.r.t. the order defined by the key).
+	public: void pop()
+	{
+		bucket_type& bucket(buckets_[min_bucket()]);
+		bucket.erase(bucket.begin());
+		--size_;
+
+		if (buckets_.size() > min_num_buckets && size_ < buckets_.size()/2)
+		{
+			resize(buckets_.size()/2);
+		}
+	}
+
+
+	/// Return the minimum element (w.r.t. the order defined by the key).
+	public: value_type const& top() const
+	{
+		return buckets_[min_bucket()].front().value;
+	}
+
+
+	/// Removes from the queue the element located at the given position.
+	public: iterator erase(iterator pos)
+	{
+		size_type b(pos.b_);
+		size_type i(pos.i_);
+
+		buckets_[b].erase(buckets_[b].begin()+i);
+		--size_;
+
+		// No resize here, since it would invalidate the returned iterator
+		return const_iterator(&buckets_, b, i);
+	}
+
+
+	/**
+	 * \brief Removes from the queue the given element.
+	 * \return \c true if the element has been found and removed; \c false
+	 *  otherwise.
+	 *
+	 * Only the bucket the element hashes to is searched.
+	 */
+	public: bool erase(value_type const& x)
+	{
+		bucket_type& bucket(buckets_[bucket_of(day_of(key_(x)))]);
+
+		typename bucket_type::iterator end_it(bucket.end());
+		for (typename bucket_type::iterator it = bucket.begin(); it != end_it; ++it)
+		{
+			if (it->value == x)
+			{
+				bucket.erase(it);
+				--size_;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+
+	/// Removes all the elements from the queue.
+	public: void clear()
+	{
+		bucket_container(min_num_buckets).swap(buckets_);
+		size_ = 0;
+		cur_day_ = 0;
+	}
+
+
+	/// Return \c true if the queue is empty; \c false otherwise.
+	public: bool empty() const
+	{
+		return size_ == 0;
+	}
+
+
+	/// Return the current size of the queue.
+	public: size_type size() const
+	{
+		return size_;
+	}
+
+
+	/// Return the current width of the buckets.
+	public: key_type bucket_width() const
+	{
+		return width_;
+	}
+
+
+	/// Return the current number of buckets.
+	public: size_type num_buckets() const
+	{
+		return buckets_.size();
+	}
+
+
+	public: const_iterator begin() const
+	{
+		return const_iterator(&buckets_, 0, 0);
+	}
+
+
+	public: const_iterator end() const
+	{
+		return const_iterator(&buckets_, buckets_.size(), 0);
+	}
+
+
+	private: key_type day_of(key_type k) const
+	{
+		return ::std::floor(k/width_);
+	}
+
+
+	private: size_type bucket_of(key_type day) const
+	{
+		key_type nb(buckets_.size());
+		key_type b(::std::fmod(day, nb));
+		if (b < 0)
+		{
+			b += nb;
+		}
+		return static_cast<size_type>(b);
+	}
+
+
+	/**
+	 * Find the bucket containing the minimum element and move the current day
+	 * to the one of that element.
+	 */
+	private: size_type min_bucket() const
+	{
+		// Scan the buckets for one year, starting from the current day
+		const size_type nb(buckets_.size());
+		key_type day(cur_day_);
+		size_type b(bucket_of(day));
+		for (size_type k = 0; k < nb; ++k)
+		{
+			bucket_type const& bucket(buckets_[b]);
+			if (!bucket.empty() && day_of(bucket.front().key) <= day)
+			{
+				cur_day_ = day;
+				return b;
+			}
+
+			day += 1;
+			b = (b+1) % nb;
+		}
+
+		// No event in this year: fall back to a direct search
+		size_type min_b(nb);
+		for (b = 0; b < nb; ++b)
+		{
+			if (!buckets_[b].empty()
+				&& (min_b == nb || node_less()(buckets_[b].front(), buckets_[min_b].front())))
+			{
+				min_b = b;
+			}
+		}
+
+		// check: the queue must not be empty
+		DCS_DEBUG_ASSERT( min_b < nb );
+
+		cur_day_ = day_of(buckets_[min_b].front().key);
+
+		return min_b;
+	}
+
+
+	/// Change the number of buckets and recompute the bucket width.
+	private: void resize(size_type new_nb)
+	{
+		// Collect all the elements
+		bucket_type nodes;
+		nodes.reserve(size_);
+		typename bucket_container::iterator bkt_end_it(buckets_.end());
+		for (typename bucket_container::iterator bkt_it = buckets_.begin(); bkt_it != bkt_end_it; ++bkt_it)
+		{
+			nodes.insert(nodes.end(), bkt_it->begin(), bkt_it->end());
+		}
+
+		// Estimate the new bucket width from the average separation of the
+		// smallest keys, discarding large separations
+		if (nodes.size() > 1)
+		{
+			size_type ns(::std::min(nodes.size(), num_width_samples));
+			::std::vector<key_type> keys;
+			keys.reserve(nodes.size());
+			typename bucket_type::const_iterator node_end_it(nodes.end());
+			for (typename bucket_type::const_iterator node_it = nodes.begin(); node_it != node_end_it; ++node_it)
+			{
+				keys.push_back(node_it->key);
+			}
+			::std::partial_sort(keys.begin(), keys.begin()+ns, keys.end());
+
+			key_type avg_sep((keys[ns-1]-keys[0])/key_type(ns-1));
+			key_type sum_sep(0);
+			size_type num_sep(0);
+			for (size_type i = 1; i < ns; ++i)
+			{
+				key_type sep(keys[i]-keys[i-1]);
+				if (sep <= 2*avg_sep)
+				{
+					sum_sep += sep;
+					++num_sep;
+				}
+			}
+			if (num_sep > 0 && sum_sep > 0)
+			{
+				width_ = key_type(3)*sum_sep/key_type(num_sep);
+			}
+
+			cur_day_ = day_of(keys[0]);
+		}
+		else if (nodes.size() == 1)
+		{
+			cur_day_ = day_of(nodes.front().key);
+		}
+
+		// Redistribute the elements
+		bucket_container(new_nb).swap(buckets_);
+		typename bucket_type::const_iterator node_end_it(nodes.end());
+		for (typename bucket_type::const_iterator node_it = nodes.begin(); node_it != node_end_it; ++node_it)
+		{
+			bucket_type& bucket(buckets_[bucket_of(day_of(node_it->key))]);
+			bucket.insert(::std::upper_bound(bucket.begin(), bucket.end(), *node_it, node_less()), *node_it);
+		}
+	}
+
+
+	/// The buckets.
+	private: bucket_container buckets_;
+	/// The width of each bucket.
+	private: key_type width_;
+	/// The number of elements.
+	private: size_type size_;
+	/// The next insertion sequence number.
+	private: sequence_type next_seq_;
+	/// The day from which to start the search of the minimum element.
+	private: mutable key_type cur_day_;
+	/// The key extractor.
+	private: key_extractor_type key_;
+};
+
+template <typename T, typename KeyT>
+const typename calendar_queue<T,KeyT>::size_type calendar_queue<T,KeyT>::min_num_buckets;
+
+template <typename T, typename KeyT>
+const typename calendar_queue<T,KeyT>::size_type calendar_queue<T,KeyT>::num_width_samples;
+
+
+/// Remove the given element from a calendar queue (bucket lookup).
+template <typename T, typename KeyT>
+bool erase_element(calendar_queue<T,KeyT>& seq, T const& x)
+{
+	return seq.erase(x);
+}
+
+/**
+ * \brief Binary heap of (pointers to) events with lazy removal.
+ *
+ * Removing an event does not touch the heap: the event is simply marked as
+ * dead (i.e., it becomes a <em>tombstone</em>) and it is discarded when it
+ * reaches the top of the heap.
+ * Thus, removing an event takes constant time and rescheduling an event only
+ * costs the insertion of a new entry.
+ * When the fraction of dead entries exceeds a given threshold (see
+ * \c compaction_threshold), dead entries are purged all at once and the heap
+ * is rebuilt in linear time.
+ *
+ * Each entry stores a copy of the key of the event at insertion time, so that
+ * a dead entry stays correctly ordered even after the event has been
+ * rescheduled.
+ * The event stores (as its list position) the insertion sequence number of
+ * its only live entry; entries with a different sequence number are dead.
+ *
+ * Events with equal keys are extracted in insertion order (i.e., FIFO order).
+ *
+ * Iteration (through \c begin and \c end) visits the live entries in heap
+ * order, which, in general, is not the sorted order.
+ *
+ * \tparam PtrEventT The type of the pointer to events.
+ * \tparam KeyT The functor extracting the (real-valued) key from an element.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <
+	typename PtrEventT,
+	typename KeyT=fire_time_key<PtrEventT>
+>
+class lazy_heap
+{
+	public: typedef PtrEventT value_type;
+	public: typedef KeyT key_extractor_type;
+	public: typedef typename KeyT::result_type key_type;
+	public: typedef value_type const* pointer;
+	public: typedef value_type const* const_pointer;
+	public: typedef value_type const& reference;
+	public: typedef value_type const& const_reference;
+	public: typedef ::std::size_t size_type;
+	public: typedef ::std::ptrdiff_t difference_type;
+	private: typedef ::std::size_t sequence_type;
+	private: struct node
+	{
+		node(value_type const& v, key_type k, sequence_type s)
+		: value(v), key(k), seq(s)
+		{
+		}
+
+		bool alive() const
+		{
+			return value->list_position() == seq;
+		}
+
+		value_type value;
+		key_type key;
+		sequence_type seq;
+	};
+	/// Order nodes so that the standard (max-)heap algorithms give a min-heap.
+	private: struct node_greater
+	{
+		bool operator()(node const& x, node const& y) const
+		{
+			return y.key < x.key || (!(x.key < y.key) && y.seq < x.seq);
+		}
+	};
+	private: typedef ::std::vector<node> node_container;
+
+
+	/// Constant iterator over the live elements of a lazy heap.
+	public: class const_iterator: public ::boost::iterator_facade<const_iterator,
+																	value_type const,
+																	::boost::forward_traversal_tag>
+	{
+		friend class ::boost::iterator_core_access;
+		friend class lazy_heap;
+
+
+		public: const_iterator()
+		: ptr_nodes_(0),
+		  i_(0)
+		{
+		}
+
+
+		private: const_iterator(node_container const* ptr_nodes, size_type i)
+		: ptr_nodes_(ptr_nodes),
+		  i_(i)
+		{
+			skip_dead();
+		}
+
+
+		private: void skip_dead()
+		{
+			while (i_ < ptr_nodes_->size() && !(*ptr_nodes_)[i_].alive())
+			{
+				++i_;
+			}
+		}
+
+
+		private: void increment()
+		{
+			++i_;
+			skip_dead();
+		}
+
+
+		private: bool equal(const_iterator const& other) const
+		{
+			return i_ == other.i_;
+		}
+
+
+		private: value_type const& dereference() const
+		{
+			return (*ptr_nodes_)[i_].value;
+		}
+
+
+		private: node_container const* ptr_nodes_;
+		private: size_type i_;
+	};
+	public: typedef const_iterator iterator;
+
+
+	private: static const ::std::size_t npos = static_cast< ::std::size_t >(-1);
+	/// The minimum number of entries for compacting the heap.
+	private: static const size_type min_compaction_size = 64;
+
+
+	/**
+	 * \brief Create an empty heap.
+	 * \param threshold The fraction of dead entries above which the heap is
+	 *  compacted.
+	 */
+	public: explicit lazy_heap(double threshold=0.5)
+	: num_dead_(0),
+	  next_seq_(0),
+	  threshold_(threshold)
+	{
+		// empty
+	}
+
+
+	/// Insert the given element (w.r.t- the order defined by the key).
+	public: void push(value_type const& x)
+	{
+		// check: an element cannot be inserted twice
+		DCS_DEBUG_ASSERT( x->list_position() == npos || !owns(x) );
+
+		const sequence_type seq(next_seq_++);
+
+		nodes_.push_back(node(x, key_(x), seq));
+		x->list_position(seq);
+		::std::push_heap(nodes_.begin(), nodes_.end(), node_greater());
+	}
+
+
+	/// Remove the top element.
+	public: void pop()
+	{
+		// pre: heap must not be empty
+		DCS_DEBUG_ASSERT( !empty() );
+
+		nodes_.front().value->list_position(npos);
+		pop_node();
+		purge_top();
+	}
+
+
+	/// Return the top element.
+	public: value_type const& top() const
+	{
+		// pre: heap must not be empty
+		DCS_DEBUG_ASSERT( !empty() );
+
+		return nodes_.front().value;
+	}
+
+
+	/**
+	 * \brief Mark the given element as dead.
+	 * \return \c true if the element has been removed; \c false if it is not
+	 *  inside the heap.
+	 */
+	public: bool erase(value_type const& x)
+	{
+		if (x->list_position() == npos || !owns(x))
+		{
+			return false;
+		}
+
+		x->list_position(npos);
+		++num_dead_;
+
+		purge_top();
+
+		if (num_dead_ > threshold_*nodes_.size() && nodes_.size() >= min_compaction_size)
+		{
+			compact();
+		}
+
+		return true;
+	}
+
+
+	/// Remove all the elements.
+	public: void clear()
+	{
+		typename node_container::const_iterator end_it(nodes_.end());
+		for (typename node_container::const_iterator it = nodes_.begin(); it != end_it; ++it)
+		{
+			if (it->alive())
+			{
+				it->value->list_position(npos);
+			}
+		}
+
+		nodes_.clear();
+		num_dead_ = 0;
+	}
+
+
+	/// Purge all the dead entries and rebuild the heap.
+	public: void compact()
+	{
+		typename node_container::iterator it(nodes_.begin());
+		typename node_container::iterator end_it(nodes_.end());
+		typename node_container::iterator out_it(it);
+		for (; it != end_it; ++it)
+		{
+			if (it->alive())
+			{
+				if (out_it != it)
+				{
+					*out_it = *it;
+				}
+				++out_it;
+			}
+		}
+		nodes_.erase(out_it, end_it);
+		::std::make_heap(nodes_.begin(), nodes_.end(), node_greater());
+		num_dead_ = 0;
+	}
+
+
+	public: bool empty() const
+	{
+		return nodes_.size() == num_dead_;
+	}
+
+
+	/// Return the number of live elements.
+	public: size_type size() const
+	{
+		return nodes_.size()-num_dead_;
+	}
+
+
+	/// Return the number of live entries.
+	public: size_type num_live() const
+	{
+		return nodes_.size()-num_dead_;
+	}
+
+
+	/// Return the number of dead entries (not yet purged).
+	public: size_type num_dead() const
+	{
+		return num_dead_;
+	}
+
+
+	/// Set the fraction of dead entries above which the heap is compacted.
+	public: void compaction_threshold(double value)
+	{
+		threshold_ = value;
+	}
+
+
+	/// Return the fraction of dead entries above which the heap is compacted.
+	public: double compaction_threshold() const
+	{
+		return threshold_;
+	}
+
+
+	public: const_iterator begin() const
+	{
+		return const_iterator(&nodes_, 0);
+	}
+
+
+	public: const_iterator end() const
+	{
+		return const_iterator(&nodes_, nodes_.size());
+	}
+
+
+	/// Tell if the live entry of the given element belongs to this heap.
+	private: bool owns(value_type const& x) const
+	{
+		// The sequence number of the live entry is always less than the next one
+		return x->list_position() < next_seq_;
+	}
+
+
+	private: void pop_node()
+	{
+		::std::pop_heap(nodes_.begin(), nodes_.end(), node_greater());
+		nodes_.pop_back();
+	}
+
+
+	/// Discard dead entries from the top of the heap.
+	private: void purge_top()
+	{
+		while (!nodes_.empty() && !nodes_.front().alive())
+		{
+			pop_node();
+			--num_dead_;
+		}
+	}
+
+
+	/// The entries (both live and dead).
+	private: node_container nodes_;
+	/// The number of dead entries.
+	private: size_type num_dead_;
+	/// The next insertion sequence number.
+	private: sequence_type next_seq_;
+	/// The fraction of dead entries triggering the compaction.
+	private: double threshold_;
+	/// The key extractor.
+	private: key_extractor_type key_;
+};
+
+template <typename PtrEventT, typename KeyT>
+const ::std::size_t lazy_heap<PtrEventT,KeyT>::npos;
+
+template <typename PtrEventT, typename KeyT>
+const typename lazy_heap<PtrEventT,KeyT>::size_type lazy_heap<PtrEventT,KeyT>::min_compaction_size;
+
+
+/// Remove the given element from a lazy heap (by marking it as dead).
+template <typename PtrEventT, typename KeyT>
+bool erase_element(lazy_heap<PtrEventT,KeyT>& seq, PtrEventT const& x)
+{
+	return seq.erase(x);
+}
+
+
+/// Return the number of dead entries of a generic sequence (always zero).
+template <typename SequenceT>
+::std::size_t num_dead_elements(SequenceT const& seq)
+{
+	DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( seq );
+
+	return 0;
+}
+
+
+/// Return the number of dead entries of a lazy heap.
+template <typename PtrEventT, typename KeyT>
+::std::size_t num_dead_elements(lazy_heap<PtrEventT,KeyT> const& seq)
+{
+	return seq.num_dead();
+}
+
+
+/**
+ * \brief Event container whose removal policy is selected at runtime.
+ *
+ * With the \c eager_event_removal policy (the default), events are kept in an
+ * indexed 4-ary heap (see \c d_ary_heap); with the \c lazy_event_removal
+ * policy, they are kept in a \c lazy_heap.
+ * The policy can only be changed while the container is empty.
+ *
+ * \tparam PtrEventT The type of the pointer to events.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename PtrEventT>
+class removal_policy_heap
+{
+	private: typedef d_ary_heap<PtrEventT,less<PtrEventT>,4,intrusive_heap_index<PtrEventT> > eager_heap_type;
+	private: typedef lazy_heap<PtrEventT> lazy_heap_type;
+	public: typedef PtrEventT value_type;
+	public: typedef value_type const* pointer;
+	public: typedef value_type const* const_pointer;
+	public: typedef value_type const& reference;
+	public: typedef value_type const& const_reference;
+	public: typedef ::std::size_t size_type;
+	public: typedef ::std::ptrdiff_t difference_type;
+
+
+	/// Constant iterator over the elements of the container.
+	public: class const_iterator: public ::boost::iterator_facade<const_iterator,
+																	value_type const,
+																	::boost::forward_traversal_tag>
+	{
+		friend class ::boost::iterator_core_access;
+		friend class removal_policy_heap;
+
+
+		public: const_iterator()
+		: eager_it_(),
+		  lazy_it_(),
+		  lazy_(false)
+		{
+		}
+
+
+		private: explicit const_iterator(typename eager_heap_type::const_iterator it)
+		: eager_it_(it),
+		  lazy_it_(),
+		  lazy_(false)
+		{
+		}
+
+
+		private: explicit const_iterator(typename lazy_heap_type::const_iterator it)
+		: eager_it_(),
+		  lazy_it_(it),
+		  lazy_(true)
+		{
+		}
+
+
+		private: void increment()
+		{
+			if (lazy_)
+			{
+				++lazy_it_;
+			}
+			else
+			{
+				++eager_it_;
+			}
+		}
+
+
+		private: bool equal(const_iterator const& other) const
+		{
+			return lazy_ ? lazy_it_ == other.lazy_it_ : eager_it_ == other.eager_it_;
+		}
+
+
+		private: value_type const& dereference() const
+		{
+			return lazy_ ? *lazy_it_ : *eager_it_;
+		}
+
+
+		private: typename eager_heap_type::const_iterator eager_it_;
+		private: typename lazy_heap_type::const_iterator lazy_it_;
+		private: bool lazy_;
+	};
+	public: typedef const_iterator iterator;
+
+
+	public: removal_policy_heap()
+	: eager_(),
+	  lazy_(),
+	  policy_(eager_event_removal)
+	{
+		// empty
+	}
+
+
+	public: void push(value_type const& x)
+	{
+		if (policy_ == lazy_event_removal)
+		{
+			lazy_.push(x);
+		}
+		else
+		{
+			eager_.push(x);
+		}
+	}
+
+
+	public: void pop()
+	{
+		if (policy_ == lazy_event_removal)
+		{
+			lazy_.pop();
+		}
+		else
+		{
+			eager_.pop();
+		}
+	}
+
+
+	public: value_type const& top() const
+	{
+		return policy_ == lazy_event_removal ? lazy_.top() : eager_.top();
+	}
+
+
+	public: bool erase(value_type const& x)
+	{
+		return policy_ == lazy_event_removal ? lazy_.erase(x) : eager_.erase(x);
+	}
+
+
+	public: void clear()
+	{
+		eager_.clear();
+		lazy_.clear();
+	}
+
+
+	public: bool empty() const
+	{
+		return policy_ == lazy_event_removal ? lazy_.empty() : eager_.empty();
+	}
+
+
+	public: size_type size() const
+	{
+		return policy_ == lazy_event_removal ? lazy_.size() : eager_.size();
+	}
+
+
+	/// Return the number of dead entries (always zero with eager removal).
+	public: size_type num_dead() const
+	{
+		return policy_ == lazy_event_removal ? lazy_.num_dead() : 0;
+	}
+
+
+	/// Set the removal policy (the container must be empty).
+	public: void removal_policy(event_removal_policy value)
+	{
+		// pre: container must be empty
+		DCS_ASSERT(
+			empty(),
+			throw ::std::logic_error("[dcs::des::detail::removal_policy_heap::removal_policy] Cannot change the removal policy of a non-empty container.")
+		);
+
+		policy_ = value;
+	}
+
+
+	public: event_removal_policy removal_policy() const
+	{
+		return policy_;
+	}
+
+
+	/// Set the fraction of dead entries above which the lazy heap is compacted.
+	public: void compaction_threshold(double value)
+	{
+		lazy_.compaction_threshold(value);
+	}
+
+
+	public: double compaction_threshold() const
+	{
+		return lazy_.compaction_threshold();
+	}
+
+
+	public: const_iterator begin() const
+	{
+		return policy_ == lazy_event_removal ? const_iterator(lazy_.begin()) : const_iterator(eager_.begin());
+	}
+
+
+	public: const_iterator end() const
+	{
+		return policy_ == lazy_event_removal ? const_iterator(lazy_.end()) : const_iterator(eager_.end());
+	}
+
+
+	/// The container used with eager removal.
+	private: eager_heap_type eager_;
+	/// The container used with lazy removal.
+	private: lazy_heap_type lazy_;
+	/// The current removal policy.
+	private: event_removal_policy policy_;
+};
+
+
+/// Remove the given element from a removal-policy heap.
+template <typename PtrEventT>
+bool erase_element(removal_policy_heap<PtrEventT>& seq, PtrEventT const& x)
+{
+	return seq.erase(x);
+}
+
+
+/// Return the number of dead entries of a removal-policy heap.
+template <typename PtrEventT>
+::std::size_t num_dead_elements(removal_policy_heap<PtrEventT> const& seq)
+{
+	return seq.num_dead();
+}
+
+
+/// Set the removal policy of a generic sequence (only eager removal is supported).
+template <typename SequenceT>
+void removal_policy(SequenceT& seq, event_removal_policy value)
+{
+	DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( seq );
+
+	// pre: value == eager_event_removal
+	DCS_ASSERT(
+		value == eager_event_removal,
+		throw ::std::invalid_argument("[dcs::des::detail::removal_policy] Lazy removal is not supported by the event container.")
+	);
+}
+
+
+/// Set the removal policy of a lazy heap (only lazy removal is supported).
+template <typename PtrEventT, typename KeyT>
+void removal_policy(lazy_heap<PtrEventT,KeyT>& seq, event_removal_policy value)
+{
+	DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( seq );
+
+	// pre: value == lazy_event_removal
+	DCS_ASSERT(
+		value == lazy_event_removal,
+		throw ::std::invalid_argument("[dcs::des::detail::removal_policy] Eager removal is not supported by the event container.")
+	);
+}
+
+
+template <typename PtrEventT>
+void removal_policy(removal_policy_heap<PtrEventT>& seq, event_removal_policy value)
+{
+	seq.removal_policy(value);
+}
+
+
+/// Return the removal policy of a generic sequence.
+template <typename SequenceT>
+event_removal_policy removal_policy(SequenceT const& seq)
+{
+	DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( seq );
+
+	return eager_event_removal;
+}
+
+
+template <typename PtrEventT, typename KeyT>
+event_removal_policy removal_policy(lazy_heap<PtrEventT,KeyT> const& seq)
+{
+	DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( seq );
+
+	return lazy_event_removal;
+}
+
+
+template <typename PtrEventT>
+event_removal_policy removal_policy(removal_policy_heap<PtrEventT> const& seq)
+{
+	return seq.removal_policy();
+}
+
+
+/// Set the compaction threshold of a generic sequence (no effect).
+template <typename SequenceT>
+void compaction_threshold(SequenceT& seq, double value)
+{
+	DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( seq );
+	DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( value );
+}
+
+
+template <typename PtrEventT, typename KeyT>
+void compaction_threshold(lazy_heap<PtrEventT,KeyT>& seq, double value)
+{
+	seq.compaction_threshold(value);
+}
+
+
+template <typename PtrEventT>
+void compaction_threshold(removal_policy_heap<PtrEventT>& seq, double value)
+{
+	seq.compaction_threshold(value);
+}
+
+
+/// Return the compaction threshold of a generic sequence (always zero).
+template <typename SequenceT>
+double compaction_threshold(SequenceT const& seq)
+{
+	DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( seq );
+
+	return 0;
+}
+
+
+template <typename PtrEventT, typename KeyT>
+double compaction_threshold(lazy_heap<PtrEventT,KeyT> const& seq)
+{
+	return seq.compaction_threshold();
+}
+
+
+template <typename PtrEventT>
+double compaction_threshold(removal_policy_heap<PtrEventT> const& seq)
+{
+	return seq.compaction_threshold();
+}
+
+}}// Namespace detail::<unnamed>
+
+/**
+ * \brief Base event-list.
+ *
+ * \tparam EventT The event type.
+ * \tparam SequenceT The event container type (default to an indexed 4-ary
+ *  heap, which can be switched to lazy removal; see \c removal_policy).
+ *
+ * For very large pending-event populations, \c detail::calendar_queue can be
+ * used in place of the default heap as the event container type.
+ * When events are frequently cancelled or rescheduled, the
+ * \c lazy_event_removal policy can be selected (see \c removal_policy), so
+ * that events are removed lazily (see \c detail::lazy_heap).
+ *
+ * Besides the event container, the list keeps a FIFO lane for
+ * <em>immediate</em> events, that is events whose fire time is equal to the
+ * current simulated time (see \c push_immediate).
+ * Immediate events are inserted and extracted in constant time, without
+ * touching the event container.
+ * Since immediate events are always scheduled after any event in the
+ * container having the same fire time, the ordering is the same as if
+ * immediate events were inserted in the container.
+ *
+ * \author Cosimo Anglano, &lt;cosimo.anglano@mfn.unipmn.it&gt;
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <
+	typename EventT,
+	//typename SequenceT=::std::priority_queue< EventT, ::std::vector<EventT>, ::std::greater<EventT> > // std::priority_queue by default returns the greater element
+	//typename SequenceT=detail::ordered_list<EventT, ::std::less<EventT> >
+	//typename SequenceT=detail::ordered_list< ::boost::shared_ptr<EventT>, detail::less< ::boost::shared_ptr<EventT> > >//[sguazt] EXP
+	typename SequenceT=detail::removal_policy_heap< ::boost::shared_ptr<EventT> >
+>
+class event_list
+{
+	/// The type of the value hold by this container.
+	public: typedef typename SequenceT::value_type value_type;
+	/// The type of the reference to the value hold by this container.
+	public: typedef typename SequenceT::reference reference;
+	/// The type of the constant reference to the value hold by this container.
+	public: typedef typename SequenceT::const_reference const_reference;
+	/// The type of the size of this container.
+	public: typedef typename SequenceT::size_type size_type;
+	/// The type of the internal container.
+	public: typedef SequenceT container_type;
+	/// The type of the container of immediate events.
+	private: typedef ::std::vector<value_type> immediate_container;
+
+
+	/// Default constructor.
+	public: event_list()
+	: seq_(),
+	  imm_(),
+	  imm_head_(0)
+	{
+		// empty
+	}
+
+
+	// compiler generated copy ctor and copy assignement are fine
+
+
+	//@{ Public member functions
+
+	/**
+	 * \brief Insert a new event in the list.
+	 * \param ptr_evt The (pointer to an) event to be inserted.
+	 */
+	public: void push(value_type const& evt)
+	{
+		seq_.push(evt);
+		evt->scheduled(true);
+	}
+
+
+	/**
+	 * \brief Insert a new immediate event in the list.
+	 * \param ptr_evt The (pointer to an) event to be inserted.
+	 *
+	 * The fire time of the event must be equal to the current simulated time,
+	 * which must not be less than the fire time of any other event in the
+	 * list.
+	 */
+	public: void push_immediate(value_type const& evt)
+	{
+		// check: immediate events must not precede other immediate events
+		DCS_DEBUG_ASSERT( imm_head_ == imm_.size() || !((*evt) < (*imm_.back())) );
+
+		imm_.push_back(evt);
+		evt->scheduled(true);
+	}
+
+
+	/**
+	 * \brief Extract the next event from the list.
+	 */
+	public: void pop()
+	{
+		if (next_is_immediate())
+		{
+			imm_[imm_head_]->scheduled(false);
+			imm_[imm_head_].reset();
+			++imm_head_;
+			if (imm_head_ == imm_.size())
+			{
+				// Lane drained: rewind it (keeping its capacity)
+				imm_.clear();
+				imm_head_ = 0;
+			}
+		}
+		else
+		{
+			seq_.top()->scheduled(false);
+			seq_.pop();
+		}
+	}
+
+
+	/**
+	 * \brief Tell if the list is empty (i.e., with no event).
+	 * \return \c true if there no event inside the list; \c false otherwise.
+	 */
+	public: bool empty() const
+	{
+		return seq_.empty() && imm_head_ == imm_.size();
+	}
+
+
+	/**
+	 * \brief Return the number of events inside the list.
+	 * \return The number of events inside the list.
+	 */
+	public: size_type size() const
+	{
+		return seq_.size()+(imm_.size()-imm_head_);
+	}
+
+
+	/**
+	 * \brief Return the number of live entries inside the list.
+	 * \return The number of events inside the list.
+	 *
+	 * This is the same as \c size and is provided for symmetry with
+	 * \c num_dead.
+	 */
+	public: size_type num_live() const
+	{
+		return size();
+	}
+
+
+	/**
+	 * \brief Return the number of dead entries inside the list.
+	 * \return The number of removed events which still take up space inside
+	 *  the event container (always zero, unless events are removed lazily).
+	 */
+	public: size_type num_dead() const
+	{
+		return detail::num_dead_elements(seq_);
+	}
+
+
+	/**
+	 * \brief Set the policy used to remove events from the list.
+	 *
+	 * The list must be empty.
+	 * Lazy removal is only supported by \c detail::removal_policy_heap (the
+	 * default event container) and by \c detail::lazy_heap.
+	 */
+	public: void removal_policy(event_removal_policy value)
+	{
+		// pre: list must be empty
+		DCS_ASSERT(
+			empty(),
+			throw ::std::logic_error("[dcs::des::event_list::removal_policy] Cannot change the removal policy of a non-empty event list.")
+		);
+
+		detail::removal_policy(seq_, value);
+	}
+
+
+	/**
+	 * \brief Return the policy used to remove events from the list.
+	 */
+	public: event_removal_policy removal_policy() const
+	{
+		return detail::removal_policy(seq_);
+	}
+
+
+	/**
+	 * \brief Set the fraction of dead entries above which the event container
+	 *  is compacted, with lazy removal.
+	 *
+	 * It has no effect on event containers that do not remove events lazily.
+	 */
+	public: void compaction_threshold(double value)
+	{
+		// pre: value >= 0
+		DCS_ASSERT(
+			value >= 0,
+			throw ::std::invalid_argument("[dcs::des::event_list::compaction_threshold] The compaction threshold cannot be negative.")
+		);
+
+		detail::compaction_threshold(seq_, value);
+	}
+
+
+	/**
+	 * \brief Return the fraction of dead entries above which the event
+	 *  container is compacted, with lazy removal.
+	 */
+	public: double compaction_threshold() const
+	{
+		return detail::compaction_threshold(seq_);
+	}
+
+
+	/**
+	 * \brief Return the internal event container (e.g., for tuning it).
+	 */
+	public: container_type& container()
+	{
+		return seq_;
+	}
+
+
+	/**
+	 * \brief Return the internal event container.
+	 */
+	public: container_type const& container() const
+	{
+		return seq_;
+	}
+
+
+	/**
+	 * \brief Return the next event from the list (without extracting it).
+	 * \return The next event.
+	 */
+	public: const_reference top() const
+	{
+		if (next_is_immediate())
+		{
+			return imm_[imm_head_];
+		}
+
+		return seq_.top();
+	}
+
+
+	/**
+	 * \brief Clear the list.
+	 */
+	public: void clear()
+	{
+		typedef typename container_type::const_iterator iterator;
+
+		iterator end_it(seq_.end());
+		for (iterator it = seq_.begin(); it != end_it; ++it)
+		{
+			(*it)->scheduled(false);
+		}
+
+		seq_.clear();
+
+		for (::std::size_t i = imm_head_; i < imm_.size(); ++i)
+		{
+			imm_[i]->scheduled(false);
+		}
+
+		imm_.clear();
+		imm_head_ = 0;
+	}
+
+
+	/**
+	 * \brief Remove the given event from the list.
+	 * \param evt The (pointer to the) event to be removed.
+	 * \return \c true if the event has been removed; \c false if the event is
+	 *  not inside the list (e.g., because it has already been fired or
+	 *  removed).
+	 *
+	 * Events which are not inside the list are detected in constant time.
+	 */
+	public: bool erase(value_type const& evt)
+	{
+		//seq_.erase(::std::find(seq_.begin(), seq_.end(), evt));
+
+		if (!evt->scheduled())
+		{
+			return false;
+		}
+
+		// Look first into the lane of immediate events (usually very short)
+		if (imm_head_ < imm_.size() && !((*imm_[imm_head_]) < (*evt)) && !((*evt) < (*imm_[imm_head_])))
+		{
+			typename immediate_container::iterator it(::std::find(imm_.begin()+imm_head_, imm_.end(), evt));
+
+			if (it != imm_.end())
+			{
+				imm_.erase(it);
+				if (imm_head_ == imm_.size())
+				{
+					imm_.clear();
+					imm_head_ = 0;
+				}
+				evt->scheduled(false);
+
+				return true;
+			}
+		}
+
+		if (!detail::erase_element(seq_, evt))
+		{
+			::std::clog << "[Warning] Event " << *evt << " not removed because it has not been found." << ::std::endl;
+			return false;
+		}
+
+		evt->scheduled(false);
+
+		return true;
+	}
+
+
+//	public: void erase(iterator pos)
+//	{
+//		seq_.erase(pos);
+//	}
+
+
+//	public: void erase(iterator first, iterator last)
+//	{
+//		seq_.erase(first, last);
+//	}
+
+
+//	public: void touch(value_type const& evt)
+//	{
+//		typedef typename container_type::iterator iterator;
+//
+////		iterator it(seq_.begin());
+////		iterator end_it(seq_.end());
+////		while (it != end_it && *it != evt)
+////		{
+////			++it;
+////		}
+//
+//		iterator end_it(seq_.end());
+//		iterator it(::std::find(seq_.begin(), end_it, evt));
+//
+//		if (it != end_it)
+//		{
+//			seq_.erase(it);
+//			push(evt);
+//		}
+//	}
+
+
+	//@} Public member functions
+
+	//@{ Private member functions
+
+	/// Tell if the next event is to be taken from the lane of immediate events.
+	private: bool next_is_immediate() const
+	{
+		// Ties go to the container, whose events have been scheduled before
+		return imm_head_ < imm_.size()
+			   && (seq_.empty() || (*imm_[imm_head_]) < (*seq_.top()));
+	}
+
+	//@} Private member functions
 
 	//@{ Member variables
 
 	/// The internal container
 	private: SequenceT seq_;
+	/// The lane of immediate events (in FIFO order, starting from imm_head_).
+	private: immediate_container imm_;
+	/// The position of the first immediate event.
+	private: ::std::size_t imm_head_;
 
 	//@} Member variables
 };
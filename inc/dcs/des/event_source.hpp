@@ -29,10 +29,15 @@
 #define DCS_DES_EVENT_SOURCE_HPP
 
 
-#include <boost/signals2.hpp>
+#ifdef DCS_DES_EVENT_SOURCE_USE_SIGNALS2
+# include <boost/signals2.hpp>
+#else
+# include <boost/function.hpp>
+#endif // DCS_DES_EVENT_SOURCE_USE_SIGNALS2
 #include <boost/smart_ptr.hpp>
 #include <cstddef>
 #include <dcs/debug.hpp>
+#include <dcs/des/detail/event_sink_list.hpp>
 #include <dcs/des/fwd.hpp>
 #include <dcs/functional/hash.hpp>
 #include <iostream>
@@ -61,6 +66,12 @@ inline ::std::string make_name(UIntT id)
 /**
  * \brief Source of simulation events.
  *
+ * By default, event sinks are dispatched through a flat list of delegates
+ * (see \c detail::event_sink_list), which involves no locking and no memory
+ * allocation when an event is emitted, but which is not thread-safe.
+ * Define the macro \c DCS_DES_EVENT_SOURCE_USE_SIGNALS2 to dispatch event
+ * sinks through (thread-safe) Boost.Signals2 signals.
+ *
  * \tparam RealT The type used for real numbers.
  *
  * \author Marco Guazzone (marco.guazzone@gmail.com)
@@ -72,9 +83,15 @@ class event_source
 	public: typedef  unsigned long uint_type;
 	private: typedef event<real_type> event_type;
 	private: typedef engine_context<real_type> engine_context_type;
+#ifdef DCS_DES_EVENT_SOURCE_USE_SIGNALS2
 	private: typedef ::boost::signals2::signal<void (event_type const&, engine_context_type&)> signal_type;
 	public: typedef typename signal_type::slot_type event_sink_type;
 	public: typedef typename ::boost::signals2::connection connection_type;
+#else
+	private: typedef detail::event_sink_list<event_type,engine_context_type> signal_type;
+	public: typedef ::boost::function<void (event_type const&, engine_context_type&)> event_sink_type;
+	public: typedef detail::event_sink_connection<event_type,engine_context_type> connection_type;
+#endif // DCS_DES_EVENT_SOURCE_USE_SIGNALS2
 
 
 	private: static uint_type counter_;
@@ -85,7 +102,8 @@ class event_source
 	: id_(++counter_),
 	  name_(detail::make_name(id_)),
 	  ptr_sig_(new signal_type()),
-	  enabled_(true)
+	  enabled_(true),
+	  internal_(false)
 	{
 		// empty
 	}
@@ -95,7 +113,8 @@ class event_source
 		: id_(++counter_),
 		  name_(name),
 		  ptr_sig_(new signal_type()),
-		  enabled_(true)
+		  enabled_(true),
+		  internal_(false)
 	{
 		// empty
 	}
@@ -106,7 +125,8 @@ class event_source
 	: id_(++counter_), // non-copyable
 	  name_(that.name_),
 	  ptr_sig_(new signal_type()), // non-copyable
-	  enabled_(that.enabled_)
+	  enabled_(that.enabled_),
+	  internal_(that.internal_)
 	{
 		// empty
 	}
@@ -121,6 +141,7 @@ class event_source
 			name_ = rhs.name_;
 			ptr_sig_ = ::boost::make_shared<signal_type>(); // non-copyable
 			enabled_ = rhs.enabled_;
+			internal_ = rhs.internal_;
 		}
 
 		return *this;
@@ -139,10 +160,18 @@ class event_source
 	}
 
 
+#ifdef DCS_DES_EVENT_SOURCE_USE_SIGNALS2
 	public: connection_type connect(event_sink_type const& sink)
 	{
 		return ptr_sig_->connect(sink);
 	}
+#else
+	public: template <typename S>
+		connection_type connect(S const& sink)
+	{
+		return connection_type(ptr_sig_, ptr_sig_->connect(sink));
+	}
+#endif // DCS_DES_EVENT_SOURCE_USE_SIGNALS2
 
 
 	public: template <typename S>
@@ -154,7 +183,11 @@ class event_source
 
 	public: void disconnect_all()
 	{
+#ifdef DCS_DES_EVENT_SOURCE_USE_SIGNALS2
 		ptr_sig_->disconnect_all_slots();
+#else
+		ptr_sig_->disconnect_all();
+#endif // DCS_DES_EVENT_SOURCE_USE_SIGNALS2
 	}
 
 
@@ -162,7 +195,11 @@ class event_source
 	{
 		if (enabled_)
 		{
+#ifdef DCS_DES_EVENT_SOURCE_USE_SIGNALS2
 			(*ptr_sig_)(evt, ctx);
+#else
+			ptr_sig_->emit(evt, ctx);
+#endif // DCS_DES_EVENT_SOURCE_USE_SIGNALS2
 		}
 	}
 
@@ -175,7 +212,11 @@ class event_source
 
 	public: ::std::size_t num_sinks() const
 	{
+#ifdef DCS_DES_EVENT_SOURCE_USE_SIGNALS2
 		return ptr_sig_->num_slots();
+#else
+		return ptr_sig_->size();
+#endif // DCS_DES_EVENT_SOURCE_USE_SIGNALS2
 	}
 
 
@@ -191,10 +232,31 @@ class event_source
 	}
 
 
+	/**
+	 * \brief Tell if this source fires engine-internal events (e.g., the
+	 *  BEGIN-OF-SIMULATION event).
+	 *
+	 * Internal events are not counted as user events by the simulation
+	 * engine.
+	 */
+	public: bool internal() const
+	{
+		return internal_;
+	}
+
+
+	/// Set whether this source fires engine-internal events.
+	public: void internal(bool value)
+	{
+		internal_ = value;
+	}
+
+
 	private: uint_type id_;
 	private: ::std::string name_;
 	private: ::boost::shared_ptr<signal_type> ptr_sig_;
 	private: bool enabled_;
+	private: bool internal_;
 };
 
 
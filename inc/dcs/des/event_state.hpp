@@ -0,0 +1,349 @@
+/**
+ * \file dcs/des/event_state.hpp
+ *
+ * \brief Type-erased event state with small-buffer storage.
+ *
+ * Copyright (C) 2012       Distributed Computing System (DCS) Group,
+ *                          Computer Science Institute,
+ *                          Department of Science and Technological Innovation,
+ *                          University of Piemonte Orientale,
+ *                          Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_EVENT_STATE_HPP
+#define DCS_DES_EVENT_STATE_HPP
+
+
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/type_traits/remove_cv.hpp>
+#include <boost/type_traits/remove_reference.hpp>
+#include <cstddef>
+#include <dcs/debug.hpp>
+#include <new>
+#include <typeinfo>
+
+
+namespace dcs { namespace des {
+
+namespace detail {
+
+/// Storage for event states.
+union event_state_storage
+{
+	/// The inline buffer.
+	unsigned char buf[32];
+	/// The pointer to heap-allocated values.
+	void* ptr;
+	// Force the maximum alignment
+	long double ld;
+	void (*pf)();
+};
+
+
+/// Table of the operations on a given type of event state.
+struct event_state_vtable
+{
+	/// Copy-construct the value stored in \a src into \a dst.
+	void (*copy)(event_state_storage const& src, event_state_storage& dst);
+	/// Destroy the value stored in \a s.
+	void (*destroy)(event_state_storage& s);
+	/// Return a pointer to the value stored in \a s.
+	void* (*get)(event_state_storage& s);
+};
+
+
+/// Tell if values of type \c T are stored inside the inline buffer.
+template <typename T>
+struct event_state_fits_inline
+{
+	static const bool value = sizeof(T) <= sizeof(event_state_storage)
+							  && ::boost::alignment_of<event_state_storage>::value % ::boost::alignment_of<T>::value == 0;
+};
+
+
+/// Operations on values stored inside the inline buffer.
+template <typename T, bool Inline = event_state_fits_inline<T>::value>
+struct event_state_ops
+{
+	static void create(T const& x, event_state_storage& s)
+	{
+		new (s.buf) T(x);
+	}
+
+	static void copy(event_state_storage const& src, event_state_storage& dst)
+	{
+		new (dst.buf) T(*reinterpret_cast<T const*>(src.buf));
+	}
+
+	static void destroy(event_state_storage& s)
+	{
+		reinterpret_cast<T*>(s.buf)->~T();
+	}
+
+	static void* get(event_state_storage& s)
+	{
+		return s.buf;
+	}
+
+	static const event_state_vtable vtable;
+};
+
+template <typename T, bool Inline>
+const event_state_vtable event_state_ops<T,Inline>::vtable = {
+	&event_state_ops<T,Inline>::copy,
+	&event_state_ops<T,Inline>::destroy,
+	&event_state_ops<T,Inline>::get
+};
+
+
+/// Operations on values too large for the inline buffer.
+template <typename T>
+struct event_state_ops<T,false>
+{
+	static void create(T const& x, event_state_storage& s)
+	{
+		s.ptr = new T(x);
+	}
+
+	static void copy(event_state_storage const& src, event_state_storage& dst)
+	{
+		dst.ptr = new T(*static_cast<T const*>(src.ptr));
+	}
+
+	static void destroy(event_state_storage& s)
+	{
+		delete static_cast<T*>(s.ptr);
+	}
+
+	static void* get(event_state_storage& s)
+	{
+		return s.ptr;
+	}
+
+	static const event_state_vtable vtable;
+};
+
+template <typename T>
+const event_state_vtable event_state_ops<T,false>::vtable = {
+	&event_state_ops<T,false>::copy,
+	&event_state_ops<T,false>::destroy,
+	&event_state_ops<T,false>::get
+};
+
+} // Namespace detail
+
+
+/**
+ * \brief Type-erased event state with small-buffer storage.
+ *
+ * Hold a value of any copy-constructible type.
+ * Values up to 32 bytes (e.g., smart pointers and small structs) are stored
+ * inside an inline buffer, so that no heap allocation takes place; larger
+ * values are heap-allocated.
+ *
+ * The type of the held value is identified by the address of a table of
+ * operations which is unique for each type; thus, checking the type of the
+ * held value is a pointer comparison and no RTTI is involved.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+class event_state
+{
+	/// Size (in bytes) of the inline buffer.
+	public: static const ::std::size_t inline_size = sizeof(detail::event_state_storage);
+
+
+	/// Default constructor: create an empty state.
+	public: event_state()
+	: ptr_vtbl_(0)
+	{
+		// empty
+	}
+
+
+	/// Create a state holding a copy of \a x.
+	public: template <typename T>
+		event_state(T const& x)
+	: ptr_vtbl_(&detail::event_state_ops<T>::vtable)
+	{
+		detail::event_state_ops<T>::create(x, storage_);
+	}
+
+
+	/// Copy constructor.
+	public: event_state(event_state const& that)
+	: ptr_vtbl_(that.ptr_vtbl_)
+	{
+		if (ptr_vtbl_)
+		{
+			ptr_vtbl_->copy(that.storage_, storage_);
+		}
+	}
+
+
+	/// Destructor.
+	public: ~event_state()
+	{
+		clear();
+	}
+
+
+	/// Copy assignment.
+	public: event_state& operator=(event_state const& rhs)
+	{
+		if (&rhs != this)
+		{
+			clear();
+			if (rhs.ptr_vtbl_)
+			{
+				rhs.ptr_vtbl_->copy(rhs.storage_, storage_);
+				ptr_vtbl_ = rhs.ptr_vtbl_;
+			}
+		}
+
+		return *this;
+	}
+
+
+	/// Assign a copy of \a x.
+	public: template <typename T>
+		event_state& operator=(T const& x)
+	{
+		if (ptr_vtbl_ == &detail::event_state_ops<T>::vtable)
+		{
+			// Same type: reuse the storage
+			*static_cast<T*>(detail::event_state_ops<T>::get(storage_)) = x;
+		}
+		else
+		{
+			clear();
+			detail::event_state_ops<T>::create(x, storage_);
+			ptr_vtbl_ = &detail::event_state_ops<T>::vtable;
+		}
+
+		return *this;
+	}
+
+
+	/// Tell if this state holds no value.
+	public: bool empty() const
+	{
+		return ptr_vtbl_ == 0;
+	}
+
+
+	/// Tell if this state holds a value of type \c T.
+	public: template <typename T>
+		bool holds() const
+	{
+		return ptr_vtbl_ == &detail::event_state_ops<typename ::boost::remove_cv<T>::type>::vtable;
+	}
+
+
+	/// Destroy the held value (if any).
+	public: void clear()
+	{
+		if (ptr_vtbl_)
+		{
+			ptr_vtbl_->destroy(storage_);
+			ptr_vtbl_ = 0;
+		}
+	}
+
+
+	/**
+	 * \brief Return a reference to the held value, without checking its type.
+	 *
+	 * The type is only checked in debug mode; use this when the type of the
+	 * held value is known at compile time (e.g., when an event source always
+	 * attaches the same type of state to its events).
+	 */
+	public: template <typename T>
+		T& get()
+	{
+		DCS_DEBUG_ASSERT( holds<T>() );
+
+		return *static_cast<T*>(detail::event_state_ops<T>::get(storage_));
+	}
+
+
+	/**
+	 * \brief Return a const reference to the held value, without checking its
+	 *  type.
+	 */
+	public: template <typename T>
+		T const& get() const
+	{
+		DCS_DEBUG_ASSERT( holds<T>() );
+
+		return *static_cast<T const*>(detail::event_state_ops<T>::get(const_cast<detail::event_state_storage&>(storage_)));
+	}
+
+
+	/// The table of operations for the held type (null if empty).
+	private: detail::event_state_vtable const* ptr_vtbl_;
+	/// The storage for the held value.
+	private: detail::event_state_storage storage_;
+};
+
+
+/**
+ * \brief Return a reference to the value held by the given state.
+ * \exception std::bad_cast If the held value is not of type \c T.
+ *
+ * \c T may be a (const) reference type.
+ */
+template <typename T>
+inline
+typename ::boost::remove_reference<T>::type& event_state_cast(event_state& s)
+{
+	typedef typename ::boost::remove_cv<typename ::boost::remove_reference<T>::type>::type value_type;
+
+	if (!s.holds<value_type>())
+	{
+		throw ::std::bad_cast();
+	}
+
+	return s.get<value_type>();
+}
+
+
+/**
+ * \brief Return a const reference to the value held by the given state.
+ * \exception std::bad_cast If the held value is not of type \c T.
+ *
+ * \c T may be a (const) reference type.
+ */
+template <typename T>
+inline
+typename ::boost::remove_reference<T>::type const& event_state_cast(event_state const& s)
+{
+	typedef typename ::boost::remove_cv<typename ::boost::remove_reference<T>::type>::type value_type;
+
+	if (!s.holds<value_type>())
+	{
+		throw ::std::bad_cast();
+	}
+
+	return s.get<value_type>();
+}
+
+}} // Namespace dcs::des
+
+
+#endif // DCS_DES_EVENT_STATE_HPP
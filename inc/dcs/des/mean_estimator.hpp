@@ -34,10 +34,10 @@
 #include <cstdlib>
 #include <dcs/debug.hpp>
 #include <dcs/des/base_statistic.hpp>
+#include <dcs/des/detail/block_moments.hpp>
+#include <dcs/des/detail/quantile_cache.hpp>
 #include <dcs/des/statistic_categories.hpp>
 #include <dcs/math/constants.hpp>
-#include <dcs/math/stats/distribution/students_t.hpp>
-#include <dcs/math/stats/function/quantile.hpp>
 #include <iostream>
 #include <string>
 
@@ -84,6 +84,25 @@ class mean_estimator: public base_statistic<ValueT,UIntT>
 	}
 
 
+	private: void do_collect_block(value_type const* obs, value_type const* /*ignored_weights*/, ::std::size_t n)
+	{
+		if (n == 0)
+		{
+			return;
+		}
+
+		// Compute the moments of the block and merge them with the current
+		// ones
+		value_type mean;
+		value_type m2;
+		detail::block_moments(obs, n, mean, m2);
+
+		value_type count(count_);
+		detail::merge_moments(count, m1_, m2_, value_type(n), mean, m2);
+		count_ += n;
+	}
+
+
 	private: value_type do_estimate() const
 	{
 		return m1_;
@@ -94,8 +113,7 @@ class mean_estimator: public base_statistic<ValueT,UIntT>
 	{
 		if (count_ > 1)
 		{
-			::dcs::math::stats::students_t_distribution<value_type> t_dist(count_-1);
-			value_type t = ::dcs::math::stats::quantile(t_dist, (value_type(1)+this->confidence_level())/value_type(2));
+			value_type t = detail::students_t_quantile(count_-1, (value_type(1)+this->confidence_level())/value_type(2));
 
 			//return ::std::sqrt(this->variance()/count_)*t;
 			return t*(this->standard_deviation()/::std::sqrt(count_));
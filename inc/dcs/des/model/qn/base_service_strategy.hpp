@@ -31,9 +31,10 @@
 
 #include <boost/smart_ptr.hpp>
 #include <dcs/debug.hpp>
+#include <dcs/des/detail/slot_map.hpp>
 #include <dcs/des/model/qn/queueing_network_traits.hpp>
 #include <dcs/des/model/qn/runtime_info.hpp>
-#include <map>
+#include <dcs/macro.hpp>
 #include <stdexcept>
 #include <vector>
 
@@ -58,8 +59,9 @@ class base_service_strategy
 	public: typedef ::boost::shared_ptr<runtime_info_type> runtime_info_pointer;
 	public: typedef service_station_node<traits_type> service_node_type;
 	public: typedef service_node_type* service_node_pointer;
+	public: typedef ::dcs::des::detail::slot_map_key info_key_type;
 	private: typedef typename customer_type::identifier_type customer_identifier_type;
-	private: typedef ::std::map<customer_identifier_type,runtime_info_pointer> runtime_info_map;
+	private: typedef ::dcs::des::detail::slot_map<runtime_info_type> runtime_info_map;
 
 
 	public: base_service_strategy()
@@ -162,8 +164,24 @@ class base_service_strategy
 //
 //		runtime_info_type rt_info(runtime);
 //		rt_info.customer_id(ptr_customer->id());
-		runtime_info_type rt_info = do_serve(ptr_customer, rng);
-		rt_infos_[ptr_customer->id()] = ::boost::make_shared<runtime_info_type>(rt_info);
+		// Reserve the slot of the runtime information of this customer, so
+		// that the strategy can already refer to the customer by its key
+		info_key_type key(rt_infos_.insert(runtime_info_type(ptr_customer, 0)));
+		ptr_customer->service_key(key);
+
+		runtime_info_type rt_info;
+		try
+		{
+			rt_info = do_serve(ptr_customer, rng);
+		}
+		catch (...)
+		{
+			// Give the reserved slot back
+			rt_infos_.erase(key);
+			ptr_customer->service_key(info_key_type());
+			throw;
+		}
+		rt_infos_[key] = rt_info;
 
 		DCS_DEBUG_TRACE_L(3, "Generated new service time: Service Demand: " << rt_info.service_demand() << " --> Runtime: " << rt_info.runtime());//XXX
 
@@ -187,12 +205,22 @@ class base_service_strategy
 
 		do_remove(ptr_customer);
 
-		rt_infos_.erase(ptr_customer->id());
+		rt_infos_.erase(info_key(*ptr_customer));
 
 		DCS_DEBUG_TRACE_L(3, "(" << this << ") BEGIN Removal of Customer: " << *ptr_customer << ".");///XXX
 	}
 
 
+	/**
+	 * \brief Called by the node when the end-of-service event of a customer
+	 *  just served has been scheduled.
+	 */
+	public: void service_scheduled(customer_type const& customer)
+	{
+		do_service_scheduled(customer);
+	}
+
+
 	public: void remove_all()
 	{
 		update_state();
@@ -203,27 +231,50 @@ class base_service_strategy
 	}
 
 
-	public: runtime_info_type& info(customer_identifier_type id)
+	/**
+	 * \brief Return the runtime information with the given key.
+	 *
+	 * The key of a customer is assigned when the customer is served (see
+	 * customer::service_key).
+	 */
+	public: runtime_info_type& info(info_key_type const& key)
 	{
+		runtime_info_type* ptr_info(rt_infos_.find(key));
+
 		// pre: customer must have already been inserted
 		DCS_ASSERT(
-			rt_infos_.count(id),
+			ptr_info,
 			throw ::std::invalid_argument("[dcs::des::model::qn::base_service_strategy::info] Runtime information not found for customer.")
 		);
 
-		return *(rt_infos_.at(id));
+		return *ptr_info;
+	}
+
+
+	/**
+	 * \brief Return the runtime information of the customer with the given
+	 *  identifier.
+	 *
+	 * This requires a linear search among the customers in service: prefer
+	 * the overloads taking the customer or its key.
+	 */
+	public: runtime_info_type& info(customer_identifier_type id)
+	{
+		return rt_infos_[find_key(id)];
 	}
 
 
 	public: runtime_info_type& info(customer_type const& customer)
 	{
-		// pre: customer pointer must be a valid pointer.
+		runtime_info_type* ptr_info(rt_infos_.find(customer.service_key()));
+
+		// pre: customer must be in service
 		DCS_ASSERT(
-			rt_infos_.count(customer.id()),
+			ptr_info && ptr_info->get_customer().id() == customer.id(),
 			throw ::std::invalid_argument("[dcs::des::model::qn::base_service_strategy::info] Invalid customer.")
 		);
 
-		return info(customer.id());
+		return *ptr_info;
 	}
 
 
@@ -235,31 +286,41 @@ class base_service_strategy
 			throw ::std::invalid_argument("[dcs::des::model::qn::base_service_strategy::info] Invalid customer.")
 		);
 
-		return info(ptr_customer->id());
+		return info(*ptr_customer);
 	}
 
 
-	public: runtime_info_type const& info(customer_identifier_type id) const
+	public: runtime_info_type const& info(info_key_type const& key) const
 	{
+		runtime_info_type const* ptr_info(rt_infos_.find(key));
+
 		// pre: customer must have already been inserted
 		DCS_ASSERT(
-			rt_infos_.count(id),
+			ptr_info,
 			throw ::std::invalid_argument("[dcs::des::model::qn::base_service_strategy::info] Runtime information not found for customer.")
 		);
 
-		return *(rt_infos_.at(id));
+		return *ptr_info;
+	}
+
+
+	public: runtime_info_type const& info(customer_identifier_type id) const
+	{
+		return rt_infos_[find_key(id)];
 	}
 
 
 	public: runtime_info_type const& info(customer_type const& customer) const
 	{
-		// pre: customer pointer must be a valid pointer.
+		runtime_info_type const* ptr_info(rt_infos_.find(customer.service_key()));
+
+		// pre: customer must be in service
 		DCS_ASSERT(
-			rt_infos_.count(customer.id()),
+			ptr_info && ptr_info->get_customer().id() == customer.id(),
 			throw ::std::invalid_argument("[dcs::des::model::qn::base_service_strategy::info] Invalid customer.")
 		);
 
-		return info(customer.id());
+		return *ptr_info;
 	}
 
 
@@ -271,7 +332,7 @@ class base_service_strategy
 			throw ::std::invalid_argument("[dcs::des::model::qn::base_service_strategy::info] Invalid customer.")
 		);
 
-		return info(ptr_customer->id());
+		return info(*ptr_customer);
 	}
 
 
@@ -296,13 +357,27 @@ class base_service_strategy
 		iterator end_it(rt_infos_.end());
 		for (iterator it = rt_infos_.begin(); it != end_it; ++it)
 		{
-			res.push_back(*(it->second));
+			res.push_back(*it);
+			res.back().share(customer_share(*it));
 		}
 
 		return res;
 	}
 
 
+	/**
+	 * \brief Return the current capacity share of the customer with the given
+	 *  runtime information.
+	 *
+	 * Strategies may compute the share on demand instead of storing it in the
+	 * runtime information of each customer.
+	 */
+	public: real_type customer_share(runtime_info_type const& rt_info) const
+	{
+		return do_customer_share(rt_info);
+	}
+
+
 	public: void reset()
 	{
 		rt_infos_.clear();
@@ -335,7 +410,7 @@ class base_service_strategy
 
 	protected: void update_state()
 	{
-		typedef typename runtime_info_map::const_iterator iterator;
+		typedef typename runtime_info_map::iterator iterator;
 
 		real_type cur_time(this->node().network().engine().simulated_time());
 
@@ -348,7 +423,7 @@ class base_service_strategy
 			iterator end_it(rt_infos_.end());
 			for (iterator it = rt_infos_.begin(); it != end_it; ++it)
 			{
-				runtime_info_type& rt_info(*(it->second));
+				runtime_info_type& rt_info(*it);
 
 				DCS_DEBUG_TRACE_L(3, "Updating Customer: " << rt_info.get_customer() << " - share: " << rt_info.share() << " - start-time: " << rt_info.start_time() << " - elapsed-time: " << (cur_time-::std::max(rt_info.start_time(),last_state_update_time_)));//XXX
 
@@ -357,7 +432,7 @@ class base_service_strategy
 					continue;
 				}
 
-				real_type share(rt_info.share());
+				real_type share(customer_share(rt_info));
 //				if (finalize)
 //				{
 //					ptr_customer->status(customer_type::node_killed_status);
@@ -390,6 +465,47 @@ class base_service_strategy
 	}
 
 
+	/// Return the key of the runtime information of the given customer, or a
+	/// stale key if the customer is not in service.
+	private: info_key_type info_key(customer_type const& customer) const
+	{
+		runtime_info_type const* ptr_info(rt_infos_.find(customer.service_key()));
+
+		if (ptr_info && ptr_info->get_customer().id() == customer.id())
+		{
+			return customer.service_key();
+		}
+
+		return info_key_type();
+	}
+
+
+	/// Return the key of the runtime information of the customer with the
+	/// given identifier.
+	private: info_key_type find_key(customer_identifier_type id) const
+	{
+		typedef typename runtime_info_map::size_type size_type;
+
+		const size_type n(rt_infos_.size());
+		typename runtime_info_map::const_iterator it(rt_infos_.begin());
+		for (size_type pos = 0; pos < n; ++pos, ++it)
+		{
+			if (it->get_customer().id() == id)
+			{
+				return rt_infos_.key(pos);
+			}
+		}
+
+		// pre: customer must have already been inserted
+		DCS_ASSERT(
+			false,
+			throw ::std::invalid_argument("[dcs::des::model::qn::base_service_strategy::find_key] Runtime information not found for customer.")
+		);
+
+		return info_key_type();
+	}
+
+
 	//@{ Interface member functions
 
 	private: virtual void do_update_service() = 0;
@@ -411,6 +527,20 @@ class base_service_strategy
 	private: virtual void do_remove_all() = 0;
 
 
+	private: virtual void do_service_scheduled(customer_type const& customer)
+	{
+		DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING(customer);
+
+		// empty
+	}
+
+
+	private: virtual real_type do_customer_share(runtime_info_type const& rt_info) const
+	{
+		return rt_info.share();
+	}
+
+
 	//private: virtual runtime_info_type info(customer_pointer const& ptr_customer) const = 0;
 
 
@@ -33,11 +33,13 @@
 #include <cstddef>
 #include <dcs/assert.hpp>
 #include <dcs/debug.hpp>
+#include <dcs/des/detail/slot_map.hpp>
 #include <dcs/des/model/qn/server_utilization_profile.hpp>
+#include <dcs/des/model/qn/visit_history_policy.hpp>
 #include <iostream>
 //#include <limits>
-#include <map>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 
@@ -54,10 +56,49 @@ class customer
 	public: typedef typename traits_type::priority_type priority_type;
 	public: typedef typename traits_type::real_type real_type;
 	public: typedef ::std::size_t identifier_type;
+	public: typedef ::dcs::des::detail::slot_map_key service_key_type;
 	public: typedef typename traits_type::network_type network_type;
 	public: typedef ::boost::shared_ptr<network_type> network_pointer;
 	public: typedef server_utilization_profile<real_type> utilization_profile_type;//EXP
 //	public: typedef typename traits_type::network_type* network_pointer;
+	/// The last visit to a node.
+	private: struct node_visit
+	{
+		node_visit()
+		: arrtime(0),
+		  deptime(0),
+		  visited(false),
+		  in_node(false),
+		  record(0)
+		{
+		}
+
+		real_type arrtime; ///< The arrival time.
+		real_type deptime; ///< The departure time (if the customer has left the node).
+		bool visited; ///< Tells if the node has been visited at least once.
+		bool in_node; ///< Tells if the customer has not left the node yet.
+		::std::size_t record; ///< The position of the visit in the visit arena (full history only).
+		::std::vector<utilization_profile_type> util_profiles; ///< The utilization profiles (last-visit history only).
+	};
+	/// A visit to a node (full history only).
+	private: struct visit_record
+	{
+		visit_record(node_identifier_type n, real_type t)
+		: node_id(n),
+		  arrtime(t),
+		  deptime(0),
+		  departed(false)
+		{
+		}
+
+		node_identifier_type node_id; ///< The visited node.
+		real_type arrtime; ///< The arrival time.
+		real_type deptime; ///< The departure time.
+		bool departed; ///< Tells if the customer has left the node.
+	};
+	private: typedef ::std::vector<node_visit> node_visit_container;
+	private: typedef ::std::vector<visit_record> visit_arena;
+	private: typedef ::std::vector< ::std::pair<node_identifier_type,utilization_profile_type> > utilization_profile_arena;
 
 
 //	/// The time value returned when the time information is not yet available.
@@ -91,10 +132,13 @@ class customer
 	  arrtime_(0),
 	  runtime_(0),
 	  deptime_(0),
-	  node_arrtimes_(),
-//	  node_runtimes_(),
-	  node_deptimes_(),
-	  node_util_profiles_()
+	  history_(last_visit_history),
+	  last_node_id_(traits_type::invalid_node_id()),
+	  last_arrtime_(0),
+	  visits_(),
+	  visit_arena_(),
+	  util_profile_arena_(),
+	  svc_key_()
 	{
 		// Empty
 	}
@@ -111,9 +155,13 @@ class customer
 	  arrtime_(0),
 	  runtime_(0),
 	  deptime_(0),
-	  node_arrtimes_(),
-//	  node_runtimes_(),
-	  node_deptimes_()
+	  history_(last_visit_history),
+	  last_node_id_(traits_type::invalid_node_id()),
+	  last_arrtime_(0),
+	  visits_(),
+	  visit_arena_(),
+	  util_profile_arena_(),
+	  svc_key_()
 	{
 		// precondition: the input class has a valid ID
 		DCS_ASSERT(
@@ -248,93 +296,274 @@ class customer
 	}
 
 
+	/**
+	 * \brief Set the policy used to record the visits of this customer to
+	 *  the nodes.
+	 *
+	 * Changing the policy discards the visits recorded so far (except the
+	 * arrival time of the latest visit).
+	 */
+	public: void visit_history(visit_history_policy policy)
+	{
+		history_ = policy;
+		visits_.clear();
+		visit_arena_.clear();
+		util_profile_arena_.clear();
+	}
+
+
+	public: visit_history_policy visit_history() const
+	{
+		return history_;
+	}
+
+
 	public: void node_arrival_time(node_identifier_type node_id, real_type time)
 	{
-//		if (node_id >= node_arrtimes_.size())
-//		{
-//			node_arrtimes_.resize(node_id+1);
-//		}
+		last_node_id_ = node_id;
+		last_arrtime_ = time;
+
+		if (history_ == no_visit_history)
+		{
+			return;
+		}
+
+		node_visit& visit(visit_at(node_id));
+
+		DCS_DEBUG_ASSERT( !visit.in_node );
+
+		visit.arrtime = time;
+		visit.visited = visit.in_node
+					  = true;
+
+		if (history_ == full_visit_history)
+		{
+			visit.record = visit_arena_.size();
+			visit_arena_.push_back(visit_record(node_id, time));
+		}
+		else
+		{
+			// Keep the memory for the profiles of the new visit
+			visit.util_profiles.clear();
+		}
+	}
 
-		DCS_DEBUG_ASSERT(
-					(node_arrtimes_.count(node_id) == 0 && node_deptimes_.count(node_id) == 0)
-				||   node_arrtimes_[node_id].size() == node_deptimes_[node_id].size()
-			);
 
-		if (node_arrtimes_.count(node_id) == 0)
+	/**
+	 * \brief Return the arrival time of the last visit to the given node.
+	 *
+	 * This takes constant time.
+	 * With the \c no_visit_history policy, only the node of the latest
+	 * visit can be queried.
+	 */
+	public: real_type node_arrival_time(node_identifier_type node_id) const
+	{
+		if (node_id == last_node_id_)
 		{
-			node_arrtimes_[node_id] = ::std::vector<real_type>();
-			node_deptimes_[node_id] = ::std::vector<real_type>();
+			return last_arrtime_;
 		}
 
-		node_arrtimes_[node_id].push_back(time);
+		// pre: a visit to the given node must have been recorded
+		DCS_ASSERT(
+			node_id < visits_.size() && visits_[node_id].visited,
+			throw ::std::logic_error("[dcs::des::model::qn::customer::node_arrival_time] No visit to the given node has been recorded.")
+		);
+
+		return visits_[node_id].arrtime;
 	}
 
 
+	/// Return the arrival times of the recorded visits to the given node.
 	public: ::std::vector<real_type> node_arrival_times(node_identifier_type node_id) const
 	{
-//		if (node_id >= node_arrtimes_.size())
-//		{
-////			return bad_time_;
-//			return ::std::vector<real_type>();
-//		}
-		if (node_arrtimes_.count(node_id) == 0)
+		::std::vector<real_type> times;
+
+		switch (history_)
 		{
-			return ::std::vector<real_type>();
+			case no_visit_history:
+				if (node_id == last_node_id_)
+				{
+					times.push_back(last_arrtime_);
+				}
+				break;
+			case last_visit_history:
+				if (node_id < visits_.size() && visits_[node_id].visited)
+				{
+					times.push_back(visits_[node_id].arrtime);
+				}
+				break;
+			case full_visit_history:
+				{
+					typedef typename visit_arena::const_iterator iterator;
+
+					iterator end_it(visit_arena_.end());
+					for (iterator it = visit_arena_.begin(); it != end_it; ++it)
+					{
+						if (it->node_id == node_id)
+						{
+							times.push_back(it->arrtime);
+						}
+					}
+				}
+				break;
 		}
 
-		return node_arrtimes_.at(node_id);
+		return times;
 	}
 
 
 	public: void node_departure_time(node_identifier_type node_id, real_type time)
 	{
-//		if (node_id >= node_deptimes_.size())
-//		{
-//			node_deptimes_.resize(node_id+1);
-//		}
+		if (history_ == no_visit_history)
+		{
+			return;
+		}
+
+		node_visit& visit(visit_at(node_id));
 
-		DCS_DEBUG_ASSERT(
-					(node_arrtimes_.count(node_id) == 1 && node_deptimes_.count(node_id) == 0)
-				||   node_arrtimes_[node_id].size() == (node_deptimes_[node_id].size()+1)
-			);
+		DCS_DEBUG_ASSERT( visit.in_node );
 
-		if (node_deptimes_.count(node_id) == 0)
+		if (history_ == full_visit_history && visit.in_node)
 		{
-			node_deptimes_[node_id] = ::std::vector<real_type>();
+			visit_arena_[visit.record].deptime = time;
+			visit_arena_[visit.record].departed = true;
 		}
 
-		node_deptimes_[node_id].push_back(time);
+		visit.deptime = time;
+		visit.in_node = false;
 	}
 
 
+	/**
+	 * \brief Return the departure time of the last visit to the given node.
+	 *
+	 * This takes constant time.
+	 * The customer must have left the node, and the \c no_visit_history
+	 * policy must not be in use.
+	 */
+	public: real_type node_departure_time(node_identifier_type node_id) const
+	{
+		// pre: a departure from the given node must have been recorded
+		DCS_ASSERT(
+			node_id < visits_.size() && visits_[node_id].visited && !visits_[node_id].in_node,
+			throw ::std::logic_error("[dcs::des::model::qn::customer::node_departure_time] No departure from the given node has been recorded.")
+		);
+
+		return visits_[node_id].deptime;
+	}
+
+
+	/// Return the departure times of the recorded visits to the given node.
 	public: ::std::vector<real_type> node_departure_times(node_identifier_type node_id) const
 	{
-//		if (node_id >= node_deptimes_.size())
-//		{
-////			return bad_time_;
-//			return ::std::vector<real_type>();
-//		}
-		if (node_deptimes_.count(node_id) == 0)
+		::std::vector<real_type> times;
+
+		switch (history_)
 		{
-			return ::std::vector<real_type>();
+			case no_visit_history:
+				break;
+			case last_visit_history:
+				if (node_id < visits_.size() && visits_[node_id].visited && !visits_[node_id].in_node)
+				{
+					times.push_back(visits_[node_id].deptime);
+				}
+				break;
+			case full_visit_history:
+				{
+					typedef typename visit_arena::const_iterator iterator;
+
+					iterator end_it(visit_arena_.end());
+					for (iterator it = visit_arena_.begin(); it != end_it; ++it)
+					{
+						if (it->node_id == node_id && it->departed)
+						{
+							times.push_back(it->deptime);
+						}
+					}
+				}
+				break;
 		}
-		return node_deptimes_.at(node_id);
+
+		return times;
 	}
 
 
 	public: void node_utilization_profile(node_identifier_type node_id, utilization_profile_type const& profile)
 	{
-		node_util_profiles_[node_id].push_back(profile);
+		switch (history_)
+		{
+			case no_visit_history:
+				break;
+			case last_visit_history:
+				visit_at(node_id).util_profiles.push_back(profile);
+				break;
+			case full_visit_history:
+				util_profile_arena_.push_back(::std::make_pair(node_id, profile));
+				break;
+		}
 	}
 
 
+	/// Return the utilization profiles of the recorded visits to the given node.
 	public: ::std::vector<utilization_profile_type> node_utilization_profiles(node_identifier_type node_id) const
 	{
-		if (node_util_profiles_.count(node_id) == 0)
+		::std::vector<utilization_profile_type> profiles;
+
+		switch (history_)
 		{
-			return ::std::vector<utilization_profile_type>();
+			case no_visit_history:
+				break;
+			case last_visit_history:
+				if (node_id < visits_.size())
+				{
+					profiles = visits_[node_id].util_profiles;
+				}
+				break;
+			case full_visit_history:
+				{
+					typedef typename utilization_profile_arena::const_iterator iterator;
+
+					iterator end_it(util_profile_arena_.end());
+					for (iterator it = util_profile_arena_.begin(); it != end_it; ++it)
+					{
+						if (it->first == node_id)
+						{
+							profiles.push_back(it->second);
+						}
+					}
+				}
+				break;
 		}
-		return node_util_profiles_.at(node_id);
+
+		return profiles;
+	}
+
+
+	/// Return the record of the last visit to the given node.
+	private: node_visit& visit_at(node_identifier_type node_id)
+	{
+		if (node_id >= visits_.size())
+		{
+			visits_.resize(node_id+1);
+		}
+
+		return visits_[node_id];
+	}
+
+
+	/// Set the key of the runtime information of this customer at the node
+	/// where it is being served (see base_service_strategy).
+	public: void service_key(service_key_type const& key)
+	{
+		svc_key_ = key;
+	}
+
+
+	/// Return the key of the runtime information of this customer at the
+	/// node where it is being served.
+	public: service_key_type const& service_key() const
+	{
+		return svc_key_;
 	}
 
 
@@ -358,13 +587,21 @@ class customer
 	private: real_type runtime_;
 	/// The departure time from the network.
 	private: real_type deptime_;
-	/// The arrival time of every passage to each node.
-	private: ::std::map< node_identifier_type ,::std::vector<real_type> > node_arrtimes_;
-//	private: ::std::vector<real_type> runtimes_;
-	/// The departure time of every passage from each node.
-	private: ::std::map< node_identifier_type, ::std::vector<real_type> > node_deptimes_;
-	/// The per-node collection of utilization profiles
-	private: ::std::map< node_identifier_type, ::std::vector<utilization_profile_type> > node_util_profiles_;
+	/// The policy used to record the visits to the nodes.
+	private: visit_history_policy history_;
+	/// The node of the latest visit.
+	private: node_identifier_type last_node_id_;
+	/// The arrival time of the latest visit.
+	private: real_type last_arrtime_;
+	/// The last visit to each node, indexed by node identifier (not used by
+	/// the \c no_visit_history policy).
+	private: node_visit_container visits_;
+	/// Every visit, in arrival order (full history only).
+	private: visit_arena visit_arena_;
+	/// Every utilization profile, in recording order (full history only).
+	private: utilization_profile_arena util_profile_arena_;
+	/// The key of the runtime information at the node where this customer is being served.
+	private: service_key_type svc_key_;
 };
 
 
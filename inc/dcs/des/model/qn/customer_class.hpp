@@ -33,6 +33,7 @@
 #include <dcs/assert.hpp>
 #include <dcs/debug.hpp>
 #include <dcs/des/model/qn/customer_class_category.hpp>
+#include <dcs/des/model/qn/visit_history_policy.hpp>
 #include <iostream>
 #include <stdexcept>
 #include <string>
@@ -60,7 +61,8 @@ class customer_class
 	: id_(traits_type::invalid_class_id()),
 	  name_(name),
 	  node_id_(traits_type::invalid_node_id()),
-	  ptr_net_()
+	  ptr_net_(),
+	  history_(last_visit_history)
 	{
 	}
 
@@ -69,7 +71,8 @@ class customer_class
 	: id_(id),
 	  name_(name),
 	  node_id_(traits_type::invalid_node_id()),
-	  ptr_net_()
+	  ptr_net_(),
+	  history_(last_visit_history)
 	{
 	}
 
@@ -165,7 +168,25 @@ class customer_class
 
 	public: customer_pointer make_customer() const
 	{
-		return do_make_customer();
+		customer_pointer ptr_customer(do_make_customer());
+
+		ptr_customer->visit_history(history_);
+
+		return ptr_customer;
+	}
+
+
+	/// Set the policy used by the customers of this class to record their
+	/// visits to the nodes.
+	public: void visit_history(visit_history_policy policy)
+	{
+		history_ = policy;
+	}
+
+
+	public: visit_history_policy visit_history() const
+	{
+		return history_;
 	}
 
 
@@ -233,6 +254,7 @@ class customer_class
 	private: ::std::string name_;
 	private: node_identifier_type node_id_;
 	private: network_pointer ptr_net_;
+	private: visit_history_policy history_;
 };
 
 
@@ -0,0 +1,493 @@
+/**
+ * \file dcs/des/model/qn/egalitarian_ps_service_strategy.hpp
+ *
+ * \brief Egalitarian processor sharing service strategy based on virtual
+ *  time.
+ *
+ * Copyright (C) 2012       Distributed Computing System (DCS) Group,
+ *                          Computer Science Institute,
+ *                          Department of Science and Technological Innovation,
+ *                          University of Piemonte Orientale,
+ *                          Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_MODEL_QN_EGALITARIAN_PS_SERVICE_STRATEGY_HPP
+#define DCS_DES_MODEL_QN_EGALITARIAN_PS_SERVICE_STRATEGY_HPP
+
+
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/debug.hpp>
+#include <dcs/des/detail/server_load_index.hpp>
+#include <dcs/des/model/qn/base_service_strategy.hpp>
+#include <dcs/math/stats/distribution/any_distribution.hpp>
+#include <dcs/math/stats/function/rand.hpp>
+#include <dcs/math/traits/float.hpp>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+
+namespace dcs { namespace des { namespace model { namespace qn {
+
+/**
+ * \brief Egalitarian processor sharing service strategy based on virtual
+ *  time.
+ *
+ * Customers are assigned to servers as in ps_service_strategy; the \f$n\f$
+ * customers running on a server share its capacity \f$c\f$ in equal parts.
+ *
+ * Each server keeps a virtual clock \f$V\f$ which advances at rate
+ * \f$c/n\f$, that is by the amount of work received by each of its
+ * customers.
+ * A customer with service demand \f$d\f$ starting at virtual time \f$V_a\f$
+ * completes when the virtual clock reaches its virtual finish time
+ * \f$F=V_a+d\f$, which does not depend on later arrivals and departures.
+ * Customers are kept ordered by virtual finish time, and only the
+ * end-of-service event of the first one is kept in the event list (the
+ * others are suspended, see service_station_node::suspend_service).
+ * Hence, an arrival or a departure reschedules at most two events, instead
+ * of the events of all the customers on the server.
+ * For the same reason, the capacity share of the customers is not stored in
+ * their runtime information, but is derived from the rate of the virtual
+ * clock of their server (see base_service_strategy::customer_share).
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename TraitsT>
+class egalitarian_ps_service_strategy: public base_service_strategy<TraitsT>
+{
+	private: typedef base_service_strategy<TraitsT> base_type;
+	public: typedef TraitsT traits_type;
+	public: typedef typename base_type::real_type real_type;
+	public: typedef typename base_type::uint_type uint_type;
+	private: typedef typename base_type::customer_type customer_type;
+	public: typedef typename base_type::customer_pointer customer_pointer;
+	public: typedef ::dcs::math::stats::any_distribution<real_type> distribution_type;
+	private: typedef ::std::vector<distribution_type> distribution_container;
+	private: typedef typename base_type::info_key_type info_key_type;
+	private: typedef ::std::multimap<real_type,info_key_type> finish_time_map;
+	private: typedef typename finish_time_map::iterator finish_time_iterator;
+	/// Indexed by the slot of the runtime information of the customers.
+	private: typedef ::std::vector<finish_time_iterator> position_container;
+	private: typedef typename base_type::random_generator_type random_generator_type;
+	private: typedef typename traits_type::class_identifier_type class_identifier_type;
+	private: typedef typename base_type::runtime_info_type runtime_info_type;
+	private: struct server_state
+	{
+		server_state()
+		: vtime(0),
+		  last_update_time(0),
+		  rate(0),
+		  armed(false),
+		  armed_key(),
+		  armed_fire_time(0)
+		{
+		}
+
+		/// The customers running on this server, ordered by virtual finish time.
+		finish_time_map finish_times;
+		/// The virtual clock.
+		real_type vtime;
+		/// The (simulated) time of the last update of the virtual clock.
+		real_type last_update_time;
+		/// The rate of the virtual clock (i.e., the capacity share of each customer).
+		real_type rate;
+		/// Tells if the end-of-service event of a customer is in the event list.
+		bool armed;
+		/// The key of the customer whose end-of-service event is in the event list.
+		info_key_type armed_key;
+		/// The fire time of the end-of-service event in the event list.
+		real_type armed_fire_time;
+	};
+	private: typedef ::std::vector<server_state> server_container;
+
+
+	public: egalitarian_ps_service_strategy()
+	: base_type(),
+	  ns_(1),
+	  servers_(ns_),
+	  num_busy_(0),
+	  next_srv_(0),
+	  loads_(ns_)
+	{
+	}
+
+
+	public: template <typename ForwardIterT>
+		egalitarian_ps_service_strategy(ForwardIterT first_distr, ForwardIterT last_distr)
+	: base_type(),
+	  ns_(1),
+	  servers_(ns_),
+	  distrs_(first_distr, last_distr),
+	  num_busy_(0),
+	  next_srv_(0),
+	  loads_(ns_)
+	{
+	}
+
+
+	public: template <typename ClassForwardIterT, typename DistrForwardIterT>
+		egalitarian_ps_service_strategy(ClassForwardIterT first_class_id, ClassForwardIterT last_class_id, DistrForwardIterT first_distr)
+	: base_type(),
+	  ns_(1),
+	  servers_(ns_),
+	  num_busy_(0),
+	  next_srv_(0),
+	  loads_(ns_)
+	{
+		init_distributions(first_class_id, last_class_id, first_distr);
+	}
+
+
+	public: template <typename ForwardIterT>
+		egalitarian_ps_service_strategy(::std::size_t num_servers, ForwardIterT first_distr, ForwardIterT last_distr)
+	: base_type(),
+	  ns_(num_servers),
+	  servers_(ns_),
+	  distrs_(first_distr, last_distr),
+	  num_busy_(0),
+	  next_srv_(0),
+	  loads_(ns_)
+	{
+	}
+
+
+	public: template <typename ClassForwardIterT, typename DistrForwardIterT>
+		egalitarian_ps_service_strategy(::std::size_t num_servers, ClassForwardIterT first_class_id, ClassForwardIterT last_class_id, DistrForwardIterT first_distr)
+	: base_type(),
+	  ns_(num_servers),
+	  servers_(ns_),
+	  num_busy_(0),
+	  next_srv_(0),
+	  loads_(ns_)
+	{
+		init_distributions(first_class_id, last_class_id, first_distr);
+	}
+
+
+	// Compiler-generated copy-constructor, copy-assignment, and destructor
+	// are fine.
+
+
+	private: template <typename ClassForwardIterT, typename DistrForwardIterT>
+		void init_distributions(ClassForwardIterT first_class_id, ClassForwardIterT last_class_id, DistrForwardIterT first_distr)
+	{
+		while (first_class_id != last_class_id)
+		{
+			class_identifier_type class_id = *first_class_id;
+
+			if (class_id >= distrs_.size())
+			{
+				distrs_.resize(class_id+1);
+			}
+
+			distrs_[class_id] = *first_distr;
+			++first_class_id;
+			++first_distr;
+		}
+	}
+
+
+	private: real_type common_share() const
+	{
+		return this->capacity_multiplier();
+	}
+
+
+	//@{ Interface member functions
+
+	private: void do_update_service()
+	{
+		real_type cur_time(this->node().network().engine().simulated_time());
+
+		for (uint_type sid = 0; sid < ns_; ++sid)
+		{
+			server_state& srv(servers_[sid]);
+
+			if (srv.finish_times.empty())
+			{
+				continue;
+			}
+
+			// The virtual clock advanced at the old rate up to now
+			advance(srv, cur_time);
+			update_rate(srv, srv.finish_times.size());
+			arm(srv);
+		}
+	}
+
+
+	private: bool do_can_serve() const
+	{
+		return true;
+	}
+
+
+	private: runtime_info_type do_serve(customer_pointer const& ptr_customer, random_generator_type& rng)
+	{
+		DCS_DEBUG_TRACE_L(3, "(" << this << ") BEGIN Do-Service of Customer: " << *ptr_customer);//XXX
+
+		// pre: customer pointer must be a valid pointer
+		DCS_DEBUG_ASSERT( ptr_customer );
+
+		real_type cur_time(this->node().network().engine().simulated_time());
+		real_type svc_time(0);
+
+		class_identifier_type class_id = ptr_customer->current_class();
+
+		while ((svc_time = ::dcs::math::stats::rand(distrs_[class_id], rng)) < 0) ;
+
+		server_state& srv(servers_[next_srv_]);
+
+		if (srv.finish_times.empty())
+		{
+			// The new customer get a dedicated server.
+			++num_busy_;
+		}
+
+		advance(srv, cur_time);
+
+		update_rate(srv, srv.finish_times.size()+1);
+
+		info_key_type key(ptr_customer->service_key());
+		if (key.index >= positions_.size())
+		{
+			positions_.resize(key.index+1);
+		}
+		positions_[key.index] = srv.finish_times.insert(::std::make_pair(srv.vtime+svc_time, key));
+		loads_.load(next_srv_, srv.finish_times.size());
+
+		runtime_info_type rt_info(ptr_customer, cur_time, svc_time);
+		rt_info.server_id(next_srv_);
+		rt_info.share(srv.rate);
+		// Let the node schedule the end of service after the time needed to
+		// do the work at the current rate of the virtual clock, which is the
+		// fire time computed by arm() when this customer is the first to
+		// complete
+		rt_info.capacity_multiplier(srv.rate);
+
+		DCS_DEBUG_TRACE_L(3, "(" << this << ") Generated service for customer: " << *ptr_customer << " - Service demand: " << rt_info.service_demand() << " - Multiplier: " << this->capacity_multiplier() << " - Share: " << srv.rate << " - Virtual finish time: " << (srv.vtime+svc_time) << " - Server: " << next_srv_);//XXX
+
+		next_srv_ = next_server(next_srv_);
+
+		DCS_DEBUG_TRACE_L(3, "(" << this << ") END Do-Service of Customer: " << *ptr_customer);//XXX
+
+		return rt_info;
+	}
+
+
+	private: void do_service_scheduled(customer_type const& customer)
+	{
+		info_key_type key(customer.service_key());
+		runtime_info_type const& rt_info(this->info(customer));
+		server_state& srv(servers_[rt_info.server_id()]);
+
+		// Only keep in the event list the end-of-service event of the first
+		// customer to complete
+		if (srv.finish_times.begin()->second == key)
+		{
+			if (srv.armed)
+			{
+				this->node().suspend_service(this->info(srv.armed_key).get_customer());
+			}
+
+			// The node has scheduled the event after the runtime of the
+			// customer (see do_serve)
+			srv.armed = true;
+			srv.armed_key = key;
+			srv.armed_fire_time = srv.last_update_time+completion_delay(srv);
+		}
+		else
+		{
+			this->node().suspend_service(customer);
+		}
+		arm(srv);
+	}
+
+
+	private: void do_remove(customer_pointer const& ptr_customer)
+	{
+		DCS_DEBUG_TRACE_L(3, "(" << this << ") BEGIN Do-Remove of Customer: " << *ptr_customer);//XXX
+
+		// precondition: customer pointer must be a valid pointer.
+		DCS_ASSERT(
+			ptr_customer,
+			throw ::std::invalid_argument("[dcs::des::model::qn::egalitarian_ps_service_strategy::do_remove] Null pointer to a customer.")
+		);
+
+		info_key_type key(ptr_customer->service_key());
+		uint_type sid(this->info(*ptr_customer).server_id());
+		server_state& srv(servers_[sid]);
+
+		advance(srv, this->node().network().engine().simulated_time());
+
+		srv.finish_times.erase(positions_[key.index]);
+		loads_.load(sid, srv.finish_times.size());
+
+		if (srv.armed && srv.armed_key == key)
+		{
+			// The end-of-service event of this customer has been fired
+			srv.armed = false;
+		}
+
+		update_rate(srv, srv.finish_times.size());
+		if (srv.finish_times.empty())
+		{
+			// Restart the virtual clock at each busy period, so that it does
+			// not grow (and lose precision) for the whole simulation
+			srv.vtime = 0;
+			--num_busy_;
+		}
+		else
+		{
+			arm(srv);
+		}
+
+		next_srv_ = next_server(sid);
+
+		DCS_DEBUG_TRACE_L(3, "(" << this << ") END Do-Remove of Customer: " << *ptr_customer);//XXX
+	}
+
+
+	private: void do_remove_all()
+	{
+		do_reset();
+	}
+
+
+	private: void do_reset()
+	{
+		servers_.clear();
+		servers_.resize(ns_);
+		positions_.clear();
+		loads_.reset(ns_);
+		num_busy_ = next_srv_
+				  = uint_type/*zero*/();
+	}
+
+
+	private: uint_type do_num_servers() const
+	{
+		return ns_;
+	}
+
+
+	private: uint_type do_num_busy_servers() const
+	{
+		return num_busy_;
+	}
+
+
+	private: real_type do_customer_share(runtime_info_type const& rt_info) const
+	{
+		// All the customers on a server get the rate of its virtual clock
+		return servers_[rt_info.server_id()].rate;
+	}
+
+	//@} Interface member functions
+
+
+	/// Advance the virtual clock of the given server up to time \a t.
+	private: static void advance(server_state& srv, real_type t)
+	{
+		srv.vtime += (t-srv.last_update_time)*srv.rate;
+		srv.last_update_time = t;
+	}
+
+
+	/// Update the rate of the virtual clock of the given server for \a nc
+	/// running customers, after a change in the number of customers or in
+	/// the capacity.
+	private: void update_rate(server_state& srv, ::std::size_t nc)
+	{
+		srv.rate = (nc > 0) ? this->common_share()/static_cast<real_type>(nc) : real_type(0);
+	}
+
+
+	/// Return the time, from the last update of the virtual clock of the given
+	/// server, to the first completion on it.
+	private: static real_type completion_delay(server_state const& srv)
+	{
+		real_type delay((srv.finish_times.begin()->first-srv.vtime)/srv.rate);
+
+		return (delay < 0) ? real_type(0) : delay;
+	}
+
+
+	/// Put (or keep) in the event list the end-of-service event of the first
+	/// customer to complete on the given server.
+	private: void arm(server_state& srv)
+	{
+		finish_time_iterator first_it(srv.finish_times.begin());
+		info_key_type key(first_it->second);
+
+		if (srv.armed && srv.armed_key != key)
+		{
+			this->node().suspend_service(this->info(srv.armed_key).get_customer());
+		}
+
+		real_type delay(completion_delay(srv));
+		real_type fire_time(srv.last_update_time+delay);
+
+		// Avoid to reschedule events whose fire time is unchanged
+		if (!srv.armed
+			|| srv.armed_key != key
+			|| !::dcs::math::float_traits<real_type>::essentially_equal(fire_time, srv.armed_fire_time))
+		{
+			this->node().reschedule_service(this->info(key).get_customer(), delay);
+		}
+
+		srv.armed = true;
+		srv.armed_key = key;
+		srv.armed_fire_time = fire_time;
+	}
+
+
+	private: uint_type next_server(uint_type start_sid) const
+	{
+		// choose the server with the smallest number of served customers
+		// (ties are broken in circular order starting from start_sid)
+		return loads_.least_loaded(start_sid);
+	}
+
+
+	//@{ Data members
+
+	/// The total number of servers.
+	private: uint_type ns_;
+	/// The servers container. For each server, it maintains the customers currently running on it and its virtual clock.
+	private: server_container servers_;
+	/// The position of each running customer in the virtual finish time map of its server.
+	private: position_container positions_;
+	/// The service distributions container.
+	private: distribution_container distrs_;
+	/// The number of current busy severs.
+	private: uint_type num_busy_;
+	/// The next server used to assign a new customer.
+	private: uint_type next_srv_;
+	/// The number of customers of each server, indexed for least-loaded server selection.
+	private: ::dcs::des::detail::server_load_index<uint_type> loads_;
+
+	//@} Data members
+};
+
+}}}} // Namespace dcs::des::model::qn
+
+
+#endif // DCS_DES_MODEL_QN_EGALITARIAN_PS_SERVICE_STRATEGY_HPP
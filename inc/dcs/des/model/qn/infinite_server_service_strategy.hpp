@@ -145,11 +145,8 @@ class infinite_server_service_strategy: public base_service_strategy<TraitsT>
 		// pre: customer pointer must be a valid pointer.
 		DCS_DEBUG_ASSERT( ptr_customer );
 
-		// Retrieve the id of this customer
-		customer_identifier_type cid(ptr_customer->id());
-
 		// Retrieve the server assigned to this customer
-		uint_type sid(this->info(cid).server_id());
+		uint_type sid(this->info(*ptr_customer).server_id());
 
 		// Erase the associated service info 
 		servers_.erase(sid);
@@ -52,7 +52,7 @@ class load_independent_service_strategy: public base_service_strategy<TraitsT>
 	public: typedef typename base_type::customer_pointer customer_pointer;
 	public: typedef ::dcs::math::stats::any_distribution<real_type> distribution_type;
 	private: typedef ::std::vector<distribution_type> distribution_container;
-	private: typedef ::std::map<uint_type,customer_pointer> server_container;
+	private: typedef ::std::vector<customer_pointer> server_container;
 	private: typedef typename customer_type::identifier_type customer_identifier_type;
 //	private: typedef ::std::map<customer_identifier_type,uint_type> customer_server_map;
 	private: typedef typename base_type::random_generator_type random_generator_type;
@@ -64,11 +64,13 @@ class load_independent_service_strategy: public base_service_strategy<TraitsT>
 	: base_type(),
 	  ns_(1),
 	  servers_(),
+	  idle_(),
 	  num_busy_(0),
 	  old_share_(0),
 	  old_multiplier_(0)
 	{
 //		servers_.reserve(ns_);
+		reset_servers();
 	}
 
 
@@ -77,12 +79,14 @@ class load_independent_service_strategy: public base_service_strategy<TraitsT>
 	: base_type(),
 	  ns_(1),
 	  servers_(),
+	  idle_(),
 	  distrs_(first_distr, last_distr),
 	  num_busy_(0),
 	  old_share_(0),
 	  old_multiplier_(0)
 	{
 //		servers_.reserve(ns_);
+		reset_servers();
 	}
 
 
@@ -91,11 +95,13 @@ class load_independent_service_strategy: public base_service_strategy<TraitsT>
 	: base_type(),
 	  ns_(1),
 	  servers_(),
+	  idle_(),
 	  num_busy_(0),
 	  old_share_(0),
 	  old_multiplier_(0)
 	{
 //		servers_.reserve(ns_);
+		reset_servers();
 
 		while (first_class_id != last_class_id)
 		{
@@ -118,11 +124,13 @@ class load_independent_service_strategy: public base_service_strategy<TraitsT>
 	: base_type(),
 	  ns_(num_servers),
 	  servers_(),
+	  idle_(),
 	  num_busy_(0),
 	  old_share_(0),
 	  old_multiplier_(0)
 	{
 //		servers_.reserve(ns_);
+		reset_servers();
 
 		while (first_distr != last_distr)
 		{
@@ -137,11 +145,13 @@ class load_independent_service_strategy: public base_service_strategy<TraitsT>
 	: base_type(),
 	  ns_(num_servers),
 	  servers_(),
+	  idle_(),
 	  num_busy_(0),
 	  old_share_(0),
 	  old_multiplier_(0)
 	{
 //		servers_.reserve(ns_);
+		reset_servers();
 
 		while (first_class_id != last_class_id)
 		{
@@ -178,8 +188,6 @@ class load_independent_service_strategy: public base_service_strategy<TraitsT>
 		// Check if there is at least one busy server.
 		if (num_busy_ > 0)
 		{
-			typedef typename server_container::const_iterator iterator;
-
 			real_type new_share(this->share());
 			real_type new_multiplier(this->capacity_multiplier());
 
@@ -195,14 +203,15 @@ class load_independent_service_strategy: public base_service_strategy<TraitsT>
 			}
 
 			real_type cur_time(this->node().network().engine().simulated_time());
-			iterator end_it(servers_.end());
-			for (iterator it = servers_.begin(); it != end_it; ++it)
+			for (uint_type sid = 0; sid < ns_; ++sid)
 			{
-				uint_type sid(it->first);
-				customer_pointer ptr_customer(it->second);
+				customer_pointer ptr_customer(servers_[sid]);
 
-				// paranoid-check: null
-				DCS_DEBUG_ASSERT( ptr_customer );
+				if (!ptr_customer)
+				{
+					// Idle server
+					continue;
+				}
 
 				DCS_DEBUG_TRACE_L(3, "(" << this << ") Running Customer ID: " << ptr_customer->id());
 
@@ -268,12 +277,16 @@ class load_independent_service_strategy: public base_service_strategy<TraitsT>
 
 //		svc_time /= this->capacity_multiplier();
 
+		// Take an idle server
+		uint_type sid(idle_.back());
+		idle_.pop_back();
+
 		runtime_info_type rt_info(ptr_customer, cur_time, svc_time);
-		rt_info.server_id(num_busy_);
+		rt_info.server_id(sid);
 		rt_info.share(this->share());
 		rt_info.capacity_multiplier(this->capacity_multiplier());
 
-		servers_[num_busy_] = ptr_customer;
+		servers_[sid] = ptr_customer;
 //		customers_servers_[ptr_customer->id()] = num_busy_;
 
 		++num_busy_;
@@ -299,32 +312,27 @@ class load_independent_service_strategy: public base_service_strategy<TraitsT>
 //			throw ::std::logic_error("[dcs::des::model::qn::load_independent_service_strategy::do_remove] Customer not in service.")
 //		);
 
-		// Retrieve the id of this customer
-		customer_identifier_type cid(ptr_customer->id());
-
 		// Retrieve the server assigned to this customer
 //		uint_type s_id = customers_servers_[c_id];
-		uint_type sid(this->info(cid).server_id());
+		uint_type sid(this->info(*ptr_customer).server_id());
 
-		// Erase the associated service info 
-		servers_.erase(sid);
-//		servers_[sid].reset();
+		// Erase the associated service info and make the server idle
+		servers_[sid].reset();
+		idle_.push_back(sid);
 		--num_busy_;
 	}
 
 
 	private: void do_remove_all()
 	{
-		servers_.clear();
-//		servers_.resize(ns_);
+		reset_servers();
 		num_busy_ = uint_type/*zero*/();
 	}
 
 
 	private: void do_reset()
 	{
-		servers_.clear();
-//		servers_.resize(ns_);
+		reset_servers();
 		num_busy_ = uint_type/*zero*/();
 		old_share_ = this->share();
 		old_multiplier_ = this->capacity_multiplier();
@@ -346,10 +354,25 @@ class load_independent_service_strategy: public base_service_strategy<TraitsT>
 	//@} Interface member functions
 
 
+	/// Make all the servers idle.
+	private: void reset_servers()
+	{
+		servers_.assign(ns_, customer_pointer());
+		idle_.clear();
+		// Idle servers are taken from the back, so lower identifiers go first
+		for (uint_type sid = ns_; sid > 0; --sid)
+		{
+			idle_.push_back(sid-1);
+		}
+	}
+
+
 	//@{ Data members
 
 	private: uint_type ns_;
 	private: server_container servers_;
+	/// The stack of the idle servers.
+	private: ::std::vector<uint_type> idle_;
 	private: distribution_container distrs_;
 	private: uint_type num_busy_;
 	private: real_type old_share_;
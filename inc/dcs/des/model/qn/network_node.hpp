@@ -646,7 +646,7 @@ class network_node: public ::dcs::des::entity
 //			accumulate_stat(response_time_statistic_category,
 //							ctx.simulated_time() - ptr_customer->arrival_time());
 			accumulate_stat(response_time_statistic_category,
-							ctx.simulated_time() - ptr_customer->node_arrival_times(id_).back());
+							ctx.simulated_time() - ptr_customer->node_arrival_time(id_));
 		}
 
 		ptr_customer->node_departure_time(id_, ctx.simulated_time());
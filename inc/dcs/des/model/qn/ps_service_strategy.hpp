@@ -31,10 +31,11 @@
 
 #include <dcs/assert.hpp>
 #include <dcs/debug.hpp>
+#include <dcs/des/detail/server_load_index.hpp>
+#include <dcs/des/detail/slot_map.hpp>
 #include <dcs/des/model/qn/base_service_strategy.hpp>
 #include <dcs/math/stats/distribution/any_distribution.hpp>
 #include <dcs/math/stats/function/rand.hpp>
-#include <set>
 #include <vector>
 
 
@@ -56,8 +57,8 @@ class ps_service_strategy: public base_service_strategy<TraitsT>
 	public: typedef typename base_type::customer_pointer customer_pointer;
 	public: typedef ::dcs::math::stats::any_distribution<real_type> distribution_type;
 	private: typedef ::std::vector<distribution_type> distribution_container;
-	private: typedef typename customer_type::identifier_type customer_identifier_type;
-	private: typedef ::std::set<customer_identifier_type> customer_set;
+	private: typedef typename base_type::info_key_type info_key_type;
+	private: typedef ::dcs::des::detail::slot_map<info_key_type> customer_set;
 	private: typedef ::std::vector<customer_set> server_container;
 	private: typedef typename base_type::random_generator_type random_generator_type;
 	private: typedef typename traits_type::class_identifier_type class_identifier_type;
@@ -69,7 +70,8 @@ class ps_service_strategy: public base_service_strategy<TraitsT>
 	  ns_(1),
 	  servers_(ns_),
 	  num_busy_(0),
-	  next_srv_(0)
+	  next_srv_(0),
+	  loads_(ns_)
 	{
 	}
 
@@ -81,7 +83,8 @@ class ps_service_strategy: public base_service_strategy<TraitsT>
 	  servers_(ns_),
 	  distrs_(first_distr, last_distr),
 	  num_busy_(0),
-	  next_srv_(0)
+	  next_srv_(0),
+	  loads_(ns_)
 	{
 	}
 
@@ -92,7 +95,8 @@ class ps_service_strategy: public base_service_strategy<TraitsT>
 	  ns_(1),
 	  servers_(ns_),
 	  num_busy_(0),
-	  next_srv_(0)
+	  next_srv_(0),
+	  loads_(ns_)
 	{
 		while (first_class_id != last_class_id)
 		{
@@ -116,7 +120,8 @@ class ps_service_strategy: public base_service_strategy<TraitsT>
 	  ns_(num_servers),
 	  servers_(ns_),
 	  num_busy_(0),
-	  next_srv_(0)
+	  next_srv_(0),
+	  loads_(ns_)
 	{
 		while (first_distr != last_distr)
 		{
@@ -132,7 +137,8 @@ class ps_service_strategy: public base_service_strategy<TraitsT>
 	  ns_(num_servers),
 	  servers_(ns_),
 	  num_busy_(0),
-	  next_srv_(0)
+	  next_srv_(0),
+	  loads_(ns_)
 	{
 		while (first_class_id != last_class_id)
 		{
@@ -266,7 +272,8 @@ class ps_service_strategy: public base_service_strategy<TraitsT>
 		rt_info.server_id(next_srv_);
 		rt_info.share(share);
 
-		servers_[next_srv_].insert(ptr_customer->id());
+		rt_info.server_key(servers_[next_srv_].insert(ptr_customer->service_key()));
+		loads_.load(next_srv_, servers_[next_srv_].size());
 
 		next_srv_ = next_server(next_srv_);
 
@@ -288,14 +295,14 @@ class ps_service_strategy: public base_service_strategy<TraitsT>
 			throw ::std::invalid_argument("[dcs::des::model::qn::ps_service_strategy::do_remove] Null pointer to a customer.")
 		);
 
-		// Retrieve the id of this customer
-		customer_identifier_type cid(ptr_customer->id());
+		runtime_info_type const& rt_info(this->info(*ptr_customer));
 
 		// Retrieve the server assigned to this customer
-		uint_type sid(this->info(cid).server_id());
+		uint_type sid(rt_info.server_id());
 
 		// Erase the associated service info 
-		servers_[sid].erase(cid);
+		servers_[sid].erase(rt_info.server_key());
+		loads_.load(sid, servers_[sid].size());
 		if (servers_[sid].size() == 0)
 		{
 			--num_busy_;
@@ -336,6 +343,7 @@ class ps_service_strategy: public base_service_strategy<TraitsT>
 	{
 		servers_.clear();
 		servers_.resize(ns_);
+		loads_.reset(ns_);
 		num_busy_ = next_srv_
 				  = uint_type/*zero*/();
 	}
@@ -345,6 +353,7 @@ class ps_service_strategy: public base_service_strategy<TraitsT>
 	{
 		servers_.clear();
 		servers_.resize(ns_);
+		loads_.reset(ns_);
 		num_busy_ = next_srv_
 				  = uint_type/*zero*/();
 	}
@@ -366,24 +375,9 @@ class ps_service_strategy: public base_service_strategy<TraitsT>
 
 	private: uint_type next_server(uint_type start_sid) const
 	{
-		uint_type best_sid(start_sid);
-
-		if (ns_ > 1 && servers_[start_sid].size() > 0)
-		{
-			// choose the server with the smallest number of served customers
-			uint_type best_sid_size(servers_[best_sid].size());
-			for (uint_type i = 1; i < ns_ && best_sid_size > 0; ++i)
-			{
-				uint_type sid((start_sid+i) % ns_);
-				if (servers_[sid].size() < servers_[best_sid].size())
-				{
-					best_sid = sid;
-					best_sid_size = servers_[best_sid].size();
-				}
-			}
-		}
-
-		return best_sid;
+		// choose the server with the smallest number of served customers
+		// (ties are broken in circular order starting from start_sid)
+		return loads_.least_loaded(start_sid);
 	}
 
 
@@ -399,6 +393,8 @@ class ps_service_strategy: public base_service_strategy<TraitsT>
 	private: uint_type num_busy_;
 	/// The next server used to assign a new customer.
 	private: uint_type next_srv_;
+	/// The number of customers of each server, indexed for least-loaded server selection.
+	private: ::dcs::des::detail::server_load_index<uint_type> loads_;
 
 	//@} Data members
 };
@@ -30,9 +30,11 @@
 
 
 #include <boost/smart_ptr.hpp>
+#include <algorithm>
 #include <cmath>
 #include <dcs/assert.hpp>
 #include <dcs/debug.hpp>
+#include <dcs/des/detail/server_load_index.hpp>
 #include <dcs/des/engine_traits.hpp>
 #include <dcs/des/model/qn/base_service_strategy.hpp>
 #include <dcs/functional/bind.hpp>
@@ -43,6 +45,7 @@
 #include <deque>
 #include <limits>
 #include <map>
+#include <stdexcept>
 #include <vector>
 
 
@@ -63,12 +66,55 @@ struct quantum_expiry_event_state
 	real_type max_fire_time;
 };
 
+
+/// The state of a server when quanta are aggregated.
+template <typename RealT, typename KeyT>
+struct aggregated_server_state
+{
+	typedef RealT real_type;
+	typedef KeyT key_type;
+
+	aggregated_server_state()
+	: quantum_left(0),
+	  last_update_time(0),
+	  rate(0),
+	  armed(false),
+	  armed_key(),
+	  armed_fire_time(0)
+	{
+	}
+
+	real_type quantum_left; ///< The time left to the quantum of the customer at the front of the server queue.
+	real_type last_update_time; ///< The (simulated) time of the last update of the work done by the customers.
+	real_type rate; ///< The amount of work done per unit of time by the customer owing the quantum.
+	bool armed; ///< Flag to indicate either or not the end-of-service event of a customer is in the event list.
+	key_type armed_key; ///< The key of the customer whose end-of-service event is in the event list.
+	real_type armed_fire_time; ///< The fire time of the end-of-service event in the event list.
+};
+
 }} // Namespace detail::<unnamed>
 
 
 /**
  * \brief Round-robin service strategy.
  *
+ * By default, the expiration of each quantum is a QUANTUM-EXPIRY event,
+ * which can be observed through \c quantum_expiry_event_source.
+ * Since quanta are usually small with respect to service times, this may
+ * result in a large number of events for each customer.
+ *
+ * When quantum aggregation is enabled (see \c quantum_aggregation), no
+ * QUANTUM-EXPIRY event is scheduled.
+ * Instead, the time of the next completion on each server is computed in
+ * closed form from the residual work of its customers, their position in the
+ * round-robin queue and the time left to the current quantum, and only the
+ * end-of-service event of the customer that completes first is kept in the
+ * event list.
+ * The work done by the customers is advanced analytically (by counting the
+ * full rounds and the quanta elapsed) only when something visible happens,
+ * that is an arrival, a departure, or a change of the share or of the
+ * capacity multiplier.
+ *
  * \author Marco Guazzone (marco.guazzone@gmail.com)
  */
 template <typename TraitsT>
@@ -83,8 +129,8 @@ class rr_service_strategy: public base_service_strategy<TraitsT>
 	public: typedef typename base_type::customer_pointer customer_pointer;
 	public: typedef ::dcs::math::stats::any_distribution<real_type> distribution_type;
 	private: typedef ::std::vector<distribution_type> distribution_container;
-	private: typedef typename customer_type::identifier_type customer_identifier_type;
-	private: typedef ::std::deque<customer_identifier_type> customer_container;
+	private: typedef typename base_type::info_key_type info_key_type;
+	private: typedef ::std::deque<info_key_type> customer_container;
 	private: typedef ::std::vector<customer_container> server_container;
 	private: typedef typename base_type::random_generator_type random_generator_type;
 	private: typedef typename traits_type::class_identifier_type class_identifier_type;
@@ -97,6 +143,8 @@ class rr_service_strategy: public base_service_strategy<TraitsT>
 	private: typedef ::boost::shared_ptr<event_type> event_pointer;
 	private: typedef detail::quantum_expiry_event_state<real_type,uint_type> quantum_expiry_event_state_type;
 	private: typedef ::std::map<uint_type,event_pointer> server_event_map;
+	private: typedef detail::aggregated_server_state<real_type,info_key_type> aggregated_server_state_type;
+	private: typedef ::std::vector<aggregated_server_state_type> aggregated_server_state_container;
 
 
 	public: explicit rr_service_strategy(real_type quantum=1.0e-5)
@@ -106,9 +154,12 @@ class rr_service_strategy: public base_service_strategy<TraitsT>
 	  servers_(ns_),
 	  num_busy_(0),
 	  next_srv_(0),
+	  loads_(ns_),
 	  ptr_quantum_expiry_evt_src_(new event_source_type("RR Quantum Exceeded")),
 	  old_share_(0),
-	  old_multiplier_(0)
+	  old_multiplier_(0),
+	  aggregate_(false),
+	  states_(ns_)
 	{
 		init();
 	}
@@ -122,9 +173,12 @@ class rr_service_strategy: public base_service_strategy<TraitsT>
 	  distrs_(first_distr, last_distr),
 	  num_busy_(0),
 	  next_srv_(0),
+	  loads_(ns_),
 	  ptr_quantum_expiry_evt_src_(new event_source_type("RR Quantum Exceeded")),
 	  old_share_(0),
-	  old_multiplier_(0)
+	  old_multiplier_(0),
+	  aggregate_(false),
+	  states_(ns_)
 	{
 		init();
 	}
@@ -137,9 +191,12 @@ class rr_service_strategy: public base_service_strategy<TraitsT>
 	  servers_(ns_),
 	  num_busy_(0),
 	  next_srv_(0),
+	  loads_(ns_),
 	  ptr_quantum_expiry_evt_src_(new event_source_type("RR Quantum Exceeded")),
 	  old_share_(0),
-	  old_multiplier_(0)
+	  old_multiplier_(0),
+	  aggregate_(false),
+	  states_(ns_)
 	{
 		while (first_class_id != last_class_id)
 		{
@@ -166,9 +223,12 @@ class rr_service_strategy: public base_service_strategy<TraitsT>
 	  servers_(ns_),
 	  num_busy_(0),
 	  next_srv_(0),
+	  loads_(ns_),
 	  ptr_quantum_expiry_evt_src_(new event_source_type("RR Quantum Exceeded")),
 	  old_share_(0),
-	  old_multiplier_(0)
+	  old_multiplier_(0),
+	  aggregate_(false),
+	  states_(ns_)
 	{
 		while (first_distr != last_distr)
 		{
@@ -187,9 +247,12 @@ class rr_service_strategy: public base_service_strategy<TraitsT>
 	  servers_(ns_),
 	  num_busy_(0),
 	  next_srv_(0),
+	  loads_(ns_),
 	  ptr_quantum_expiry_evt_src_(new event_source_type("RR Quantum Exceeded")),
 	  old_share_(0),
-	  old_multiplier_(0)
+	  old_multiplier_(0),
+	  aggregate_(false),
+	  states_(ns_)
 	{
 		while (first_class_id != last_class_id)
 		{
@@ -212,6 +275,29 @@ class rr_service_strategy: public base_service_strategy<TraitsT>
 	}
 
 
+	/**
+	 * \brief Enable or disable the aggregation of quanta.
+	 *
+	 * The aggregation mode can only be changed when no customer is in
+	 * service.
+	 */
+	public: void quantum_aggregation(bool value)
+	{
+		// pre: no customer is in service
+		DCS_ASSERT(
+			num_busy_ == 0,
+			throw ::std::logic_error("[dcs::des::model::qn::rr_service_strategy::quantum_aggregation] Cannot change the aggregation mode while customers are in service.")
+		);
+
+		aggregate_ = value;
+	}
+
+	/// Tell if quanta are aggregated.
+	public: bool quantum_aggregation() const
+	{
+		return aggregate_;
+	}
+
 	public: event_source_type& quantum_expiry_event_source()
 	{
 		return *ptr_quantum_expiry_evt_src_;
@@ -224,6 +310,12 @@ class rr_service_strategy: public base_service_strategy<TraitsT>
 
 	private: void do_update_service()
 	{
+		if (aggregate_)
+		{
+			update_aggregated_service();
+			return;
+		}
+
 		DCS_DEBUG_TRACE_L(3, "(" << this << ") BEGIN Do-Update-Service (Clock: " << this->node().network().engine().simulated_time() << ")");//XXX
 
 		typedef typename server_event_map::iterator server_event_iterator;
@@ -261,11 +353,11 @@ class rr_service_strategy: public base_service_strategy<TraitsT>
 			//real_type work_done(elapsed_time*old_share_);
 			real_type work_done(state.work-time_to_fire*old_multiplier_);
 
-			customer_identifier_type cid(servers_[sid].front());
+			info_key_type key(servers_[sid].front());
 
-			DCS_DEBUG_TRACE_L(3, "(" << this << ") Running Customer ID: " << cid);
+			DCS_DEBUG_TRACE_L(3, "(" << this << ") Running Customer Key: " << key);
 
-			runtime_info_type& rt_info(this->info(cid));
+			runtime_info_type& rt_info(this->info(key));
 
 			DCS_DEBUG_TRACE_L(3, "Updating Customer: " << rt_info.get_customer() << " - Service demand: " << rt_info.service_demand() << " - Multiplier: " << this->capacity_multiplier() << " - Quantum: " << this->quantum() << " - Elapsed Time: " << (cur_time-state.update_time) << " - Work done: " << work_done << " - old share: " << rt_info.share() << " - runtime: " << rt_info.runtime() << " - old completed work: " << rt_info.completed_work() << " - old residual-work: " << rt_info.residual_work() << " (Clock: " << engine.simulated_time() << ")");//XXX
 
@@ -347,6 +439,11 @@ class rr_service_strategy: public base_service_strategy<TraitsT>
 
         while ((svc_time = ::dcs::math::stats::rand(distrs_[class_id], rng)) < 0) ;
 
+		if (aggregate_)
+		{
+			return serve_aggregated(ptr_customer, svc_time);
+		}
+
 		if (num_busy_ < ns_)
 		{
 			// The new customer get a dedicated server.
@@ -361,7 +458,8 @@ class rr_service_strategy: public base_service_strategy<TraitsT>
 		rt_info.capacity_multiplier(multiplier);
 		//rt_info.temporary(true);
 
-		servers_[next_srv_].push_back(ptr_customer->id());
+		servers_[next_srv_].push_back(ptr_customer->service_key());
+		loads_.load(next_srv_, servers_[next_srv_].size());
 
 		// Check if we need to schedule the QUANTUM-EXPIRY event
 		if (servers_[next_srv_].size() == 1)
@@ -441,14 +539,17 @@ class rr_service_strategy: public base_service_strategy<TraitsT>
 			throw ::std::invalid_argument("[dcs::des::model::qn::rr_service_strategy::do_remove] Null pointer to a customer.")
 		);
 
-		// Retrieve the id of this customer
-		customer_identifier_type cid(ptr_customer->id());
+		if (aggregate_)
+		{
+			remove_aggregated(ptr_customer->service_key());
+			return;
+		}
 
 		// Retrieve the server assigned to this customer
-		uint_type sid(this->info(cid).server_id());
+		uint_type sid(this->info(*ptr_customer).server_id());
 
 //		// check: the customer removed is the customer currently in execution
-//		DCS_DEBUG_ASSERT( cid == servers_[sid].front() );
+//		DCS_DEBUG_ASSERT( key == servers_[sid].front() );
 //
 //		// Erase the associated service info 
 //		servers_[sid].pop_front();
@@ -470,18 +571,38 @@ class rr_service_strategy: public base_service_strategy<TraitsT>
 	{
 		servers_.clear();
 		servers_.resize(ns_);
+		loads_.reset(ns_);
 		num_busy_ = next_srv_
 				  = uint_type/*zero*/();
 		srv_evt_map_.clear(); //FIXME: should we really do this?
+		states_.clear();
+		states_.resize(ns_);
+	}
+
+	private: void do_service_scheduled(customer_type const& customer)
+	{
+		// The end of service is driven by this strategy (either by the
+		// QUANTUM-EXPIRY events or by the aggregated quanta), so keep the
+		// event out of the event list until the customer has done all its
+		// work.
+		this->node().suspend_service(customer);
+
+		if (aggregate_)
+		{
+			arm(this->info(customer).server_id());
+		}
 	}
 
 	private: void do_reset()
 	{
 		servers_.clear();
 		servers_.resize(ns_);
+		loads_.reset(ns_);
 		num_busy_ = next_srv_
 				  = uint_type/*zero*/();
 		srv_evt_map_.clear();
+		states_.clear();
+		states_.resize(ns_);
 		old_share_ = this->share();
 		old_multiplier_ = this->capacity_multiplier();
 	}
@@ -510,24 +631,9 @@ class rr_service_strategy: public base_service_strategy<TraitsT>
 
 	private: uint_type next_server(uint_type start_sid) const
 	{
-		uint_type best_sid(start_sid);
-
-		if (ns_ > 1 && servers_[start_sid].size() > 0)
-		{
-			// choose the server with the smallest number of served customers
-			uint_type best_sid_size(servers_[best_sid].size());
-			for (uint_type i = 1; i < ns_ && best_sid_size > 0; ++i)
-			{
-				uint_type sid((start_sid+i) % ns_);
-				if (servers_[sid].size() < servers_[best_sid].size())
-				{
-					best_sid = sid;
-					best_sid_size = servers_[best_sid].size();
-				}
-			}
-		}
-
-		return best_sid;
+		// choose the server with the smallest number of served customers
+		// (ties are broken in circular order starting from start_sid)
+		return loads_.least_loaded(start_sid);
 	}
 
 	private: void schedule_quantum_expiry(quantum_expiry_event_state_type& state, real_type delay)
@@ -571,16 +677,16 @@ class rr_service_strategy: public base_service_strategy<TraitsT>
 
 		real_type cur_time(this->node().network().engine().simulated_time());
 		uint_type sid(state.sid);
-		customer_identifier_type cid(servers_[sid].front());
+		info_key_type key(servers_[sid].front());
 		servers_[sid].pop_front();
 
-		DCS_DEBUG_TRACE_L(3, "Current Customer ID: " << cid);//XXX
+		DCS_DEBUG_TRACE_L(3, "Current Customer Key: " << key);//XXX
 //if (dynamic_cast< ::dcs::des::replications::engine<real_type,uint_type> const&>(this->node().network().engine()).num_replications() == 2 && this->node().network().engine().simulated_time()>28900)//XXX
 //{//XXX
-//::std::cerr << "Node: " << this->node() << " -- Current Customer ID: " << cid << " (Clock: " << this->node().network().engine().simulated_time() << ")" << ::std::endl;//XXX
+//::std::cerr << "Node: " << this->node() << " -- Current Customer Key: " << key << " (Clock: " << this->node().network().engine().simulated_time() << ")" << ::std::endl;//XXX
 //}//XXX
 
-		runtime_info_type& rt_info(this->info(cid));
+		runtime_info_type& rt_info(this->info(key));
 
 		DCS_DEBUG_TRACE_L(3, "Updating Customer: " << rt_info.get_customer() << " - Service demand: " << rt_info.service_demand() << " - Multiplier: " << this->capacity_multiplier() << " - Quantum: " << this->quantum() << " - State.Work: " << state.work << " - old share: " << rt_info.share() << " - runtime: " << rt_info.runtime() << " - old completed work: " << rt_info.completed_work() << " - old residual-work: " << rt_info.residual_work() << " (Clock: " << this->node().network().engine().simulated_time() << ")");//XXX
 //if (dynamic_cast< ::dcs::des::replications::engine<real_type,uint_type> const&>(this->node().network().engine()).num_replications() == 2 && this->node().network().engine().simulated_time()>28900)//XXX
@@ -600,8 +706,9 @@ class rr_service_strategy: public base_service_strategy<TraitsT>
 		{
 			// This customer still need some more time to finish.
 			// Execution will continue on the next RR tournament.
-			servers_[sid].push_back(cid);
+			servers_[sid].push_back(key);
 		} // else this customer is done
+		loads_.load(sid, servers_[sid].size());
 
 		DCS_DEBUG_TRACE_L(3, "Updated Customer: " << rt_info.get_customer() << " - Service demand: " << rt_info.service_demand() << " - Multiplier: " << this->capacity_multiplier() << " - Quantum: " << this->quantum() << " - new share: " << rt_info.share() << " - new runtime: " << rt_info.runtime() << " - new completed work: " << rt_info.completed_work() << " - new residual-work: " << rt_info.residual_work() << " (Clock: " << this->node().network().engine().simulated_time() << ")");//XXX
 //if (dynamic_cast< ::dcs::des::replications::engine<real_type,uint_type> const&>(this->node().network().engine()).num_replications() == 2 && this->node().network().engine().simulated_time()>28900)//XXX
@@ -613,15 +720,15 @@ class rr_service_strategy: public base_service_strategy<TraitsT>
 		// will not execute more than it need.
 		if (servers_[sid].size() > 0)
 		{
-			customer_identifier_type next_cid = servers_[sid].front();
+			info_key_type next_key = servers_[sid].front();
 
-			DCS_DEBUG_TRACE_L(3, "Next Customer ID: " << next_cid << " (Clock: " << this->node().network().engine().simulated_time() << ")");//XXX
+			DCS_DEBUG_TRACE_L(3, "Next Customer Key: " << next_key << " (Clock: " << this->node().network().engine().simulated_time() << ")");//XXX
 //if (dynamic_cast< ::dcs::des::replications::engine<real_type,uint_type> const&>(this->node().network().engine()).num_replications() == 2 && this->node().network().engine().simulated_time()>28900)//XXX
 //{//XXX
-//::std::cerr << "Node: " << this->node() << " -- Next Customer ID: " << next_cid << " (Clock: " << this->node().network().engine().simulated_time() << ")" << ::std::endl;//XXX
+//::std::cerr << "Node: " << this->node() << " -- Next Customer Key: " << next_key << " (Clock: " << this->node().network().engine().simulated_time() << ")" << ::std::endl;//XXX
 //}//XXX
 
-			runtime_info_type& next_rt_info(this->info(next_cid));
+			runtime_info_type& next_rt_info(this->info(next_key));
 			next_rt_info.share(this->share());
 			next_rt_info.capacity_multiplier(this->capacity_multiplier());
 			real_type residual_time(next_rt_info.residual_work()/this->capacity_multiplier());
@@ -649,7 +756,7 @@ class rr_service_strategy: public base_service_strategy<TraitsT>
 //if (dynamic_cast< ::dcs::des::replications::engine<real_type,uint_type> const&>(this->node().network().engine()).num_replications() == 2 && this->node().network().engine().simulated_time()>28900)//XXX
 //{//XXX
 //::std::cerr << "Node: " << this->node() << " -- Next Customer: " << next_rt_info.get_customer() << " - Service demand: " << next_rt_info.service_demand() << " - Multiplier: " << this->capacity_multiplier() << " - Quantum: " << this->quantum() << " - share: " << next_rt_info.share() << " - runtime: " << next_rt_info.runtime() << " - completed work: " << next_rt_info.completed_work() << " - residual-work: " << next_rt_info.residual_work() << " (Clock: " << this->node().network().engine().simulated_time() << ")" << ::std::endl;//XXX
-//::std::cerr << "Node: " << this->node() << " -- Scheduling next QUANTUM-EXPIRY for Customer ID: " << cid << " at " << (this->node().network().engine().simulated_time()+state.work) << " (Clock: " << this->node().network().engine().simulated_time() << ")" << ::std::endl;//XXX
+//::std::cerr << "Node: " << this->node() << " -- Scheduling next QUANTUM-EXPIRY for Customer Key: " << key << " at " << (this->node().network().engine().simulated_time()+state.work) << " (Clock: " << this->node().network().engine().simulated_time() << ")" << ::std::endl;//XXX
 //}//XXX
 
 			schedule_quantum_expiry(state, delay);
@@ -661,15 +768,15 @@ class rr_service_strategy: public base_service_strategy<TraitsT>
 
 ////if (dynamic_cast< ::dcs::des::replications::engine<real_type,uint_type> const&>(this->node().network().engine()).num_replications() == 2 && this->node().network().engine().simulated_time()>28900)//XXX
 ////{//XXX
-////::std::cerr << "Node: " << this->node() << " -- Rescheduling End-of-Service of Customer ID: " << cid << " at " << (this->node().network().engine().simulated_time()+delay) << " (Clock: " << this->node().network().engine().simulated_time() << ")" << ::std::endl;//XXX
+////::std::cerr << "Node: " << this->node() << " -- Rescheduling End-of-Service of Customer Key: " << key << " at " << (this->node().network().engine().simulated_time()+delay) << " (Clock: " << this->node().network().engine().simulated_time() << ")" << ::std::endl;//XXX
 ////}//XXX
 //		this->node().reschedule_service(rt_info.get_customer(), delay);
 		if (::dcs::math::float_traits<real_type>::approximately_equal(residual_work, static_cast<real_type>(0)))
 		{
-			DCS_DEBUG_TRACE_L(3, "Node: " << this->node() << " -- Rescheduling End-of-Service of Customer ID: " << cid << " NOW (Clock: " << this->node().network().engine().simulated_time() << ")");//XXX
+			DCS_DEBUG_TRACE_L(3, "Node: " << this->node() << " -- Rescheduling End-of-Service of Customer Key: " << key << " NOW (Clock: " << this->node().network().engine().simulated_time() << ")");//XXX
 //if (dynamic_cast< ::dcs::des::replications::engine<real_type,uint_type> const&>(this->node().network().engine()).num_replications() == 2 && this->node().network().engine().simulated_time()>28900)//XXX
 //{//XXX
-//::std::cerr << "Node: " << this->node() << " -- Rescheduling End-of-Service of Customer ID: " << cid << " NOW (Clock: " << this->node().network().engine().simulated_time() << ")" << ::std::endl;//XXX
+//::std::cerr << "Node: " << this->node() << " -- Rescheduling End-of-Service of Customer Key: " << key << " NOW (Clock: " << this->node().network().engine().simulated_time() << ")" << ::std::endl;//XXX
 //}//XXX
 			this->node().reschedule_service(rt_info.get_customer(), 0);
 		}
@@ -678,6 +785,269 @@ class rr_service_strategy: public base_service_strategy<TraitsT>
 	}
 
 
+	private: runtime_info_type serve_aggregated(customer_pointer const& ptr_customer, real_type svc_time)
+	{
+		const real_type cur_time(this->node().network().engine().simulated_time());
+		const uint_type sid(next_srv_);
+		customer_container& queue(servers_[sid]);
+		aggregated_server_state_type& state(states_[sid]);
+
+		advance(sid, cur_time);
+		if (queue.empty())
+		{
+			// The new customer get a dedicated server.
+			++num_busy_;
+			state.quantum_left = quantum();
+		}
+		state.rate = this->capacity_multiplier();
+
+		queue.push_back(ptr_customer->service_key());
+		loads_.load(sid, queue.size());
+
+		runtime_info_type rt_info(ptr_customer, cur_time, svc_time);
+		rt_info.server_id(sid);
+		rt_info.share(this->share());
+		rt_info.capacity_multiplier(this->capacity_multiplier());
+
+		// The end-of-service event is put in the event list as soon as it is
+		// scheduled by the node (see do_service_scheduled)
+
+		next_srv_ = next_server(sid);
+
+		return rt_info;
+	}
+
+	private: void remove_aggregated(info_key_type const& key)
+	{
+		const uint_type sid(this->info(key).server_id());
+		customer_container& queue(servers_[sid]);
+		aggregated_server_state_type& state(states_[sid]);
+
+		advance(sid, this->node().network().engine().simulated_time());
+
+		typename customer_container::iterator it(::std::find(queue.begin(), queue.end(), key));
+
+		// check: the customer must be served by this server
+		DCS_DEBUG_ASSERT( it != queue.end() );
+
+		if (it == queue.begin())
+		{
+			// The next customer starts a new quantum
+			state.quantum_left = quantum();
+		}
+		queue.erase(it);
+		loads_.load(sid, queue.size());
+
+		if (state.armed && state.armed_key == key)
+		{
+			// The end-of-service event of this customer has been fired
+			state.armed = false;
+		}
+
+		if (queue.empty())
+		{
+			--num_busy_;
+		}
+		else
+		{
+			arm(sid);
+		}
+
+		next_srv_ = next_server(sid);
+	}
+
+	private: void update_aggregated_service()
+	{
+		typedef typename customer_container::const_iterator customer_iterator;
+
+		const real_type cur_time(this->node().network().engine().simulated_time());
+		const real_type share(this->share());
+
+		for (uint_type sid = 0; sid < ns_; ++sid)
+		{
+			// The work has been done at the old rate up to now
+			advance(sid, cur_time);
+			states_[sid].rate = this->capacity_multiplier();
+
+			if (servers_[sid].empty())
+			{
+				continue;
+			}
+
+			customer_iterator end_it(servers_[sid].end());
+			for (customer_iterator it = servers_[sid].begin(); it != end_it; ++it)
+			{
+				this->info(*it).share(share);
+			}
+
+			arm(sid);
+		}
+
+		old_share_ = share;
+		old_multiplier_ = this->capacity_multiplier();
+	}
+
+	/// Advance the work done by the customers of the given server up to time
+	/// \a t, assuming that none of them completes before.
+	private: void advance(uint_type sid, real_type t)
+	{
+		typedef typename customer_container::const_iterator customer_iterator;
+
+		customer_container& queue(servers_[sid]);
+		aggregated_server_state_type& state(states_[sid]);
+
+		real_type dt(t-state.last_update_time);
+		state.last_update_time = t;
+
+		if (queue.empty() || dt <= 0)
+		{
+			return;
+		}
+
+		// The rest of the current quantum
+		if (dt < state.quantum_left)
+		{
+			add_work(queue.front(), dt*state.rate);
+			state.quantum_left -= dt;
+			return;
+		}
+		add_work(queue.front(), state.quantum_left*state.rate);
+		dt -= state.quantum_left;
+		queue.push_back(queue.front());
+		queue.pop_front();
+
+		// The full rounds
+		const real_type round_time(quantum()*queue.size());
+		const real_type num_rounds(::std::floor(dt/round_time));
+		if (num_rounds > 0)
+		{
+			const real_type work(num_rounds*quantum()*state.rate);
+
+			customer_iterator end_it(queue.end());
+			for (customer_iterator it = queue.begin(); it != end_it; ++it)
+			{
+				add_work(*it, work);
+			}
+			dt -= num_rounds*round_time;
+		}
+
+		// The full quanta of the last round
+		while (dt >= quantum())
+		{
+			add_work(queue.front(), quantum()*state.rate);
+			dt -= quantum();
+			queue.push_back(queue.front());
+			queue.pop_front();
+		}
+
+		// The current quantum
+		add_work(queue.front(), dt*state.rate);
+		state.quantum_left = quantum()-dt;
+	}
+
+	private: void add_work(info_key_type const& key, real_type work)
+	{
+		runtime_info_type& rt_info(this->info(key));
+
+		// Take care of rounding errors
+		rt_info.accumulate_work2(::std::min(work, rt_info.residual_work()));
+	}
+
+	/// Return the time needed by the customer at position \a pos of the queue
+	/// of a server with \a nc customers to complete its residual work \a work,
+	/// assuming that none of the other customers completes before.
+	private: real_type completion_delay(aggregated_server_state_type const& state, ::std::size_t nc, ::std::size_t pos, real_type work) const
+	{
+		real_type delay(0);
+
+		if (pos == 0)
+		{
+			const real_type left_work(state.quantum_left*state.rate);
+
+			if (work <= left_work)
+			{
+				return work/state.rate;
+			}
+			work -= left_work;
+
+			// The other customers get their quantum first
+			delay = state.quantum_left+(nc-1)*quantum();
+		}
+		else
+		{
+			delay = state.quantum_left+(pos-1)*quantum();
+		}
+
+		// The number of quanta (the last one may be partial) needed to complete
+		const real_type quantum_work(quantum()*state.rate);
+		const real_type ratio(work/quantum_work);
+		real_type num_quanta(::std::ceil(ratio));
+		if (num_quanta < 1)
+		{
+			num_quanta = 1;
+		}
+		else if (num_quanta > 1 && ::dcs::math::float_traits<real_type>::approximately_equal(ratio, num_quanta-1))
+		{
+			num_quanta -= 1;
+		}
+
+		const real_type last_work(::std::max(work-(num_quanta-1)*quantum_work, real_type(0)));
+
+		return delay+(num_quanta-1)*nc*quantum()+last_work/state.rate;
+	}
+
+	/// Put (or keep) in the event list the end-of-service event of the first
+	/// customer to complete on the given server.
+	private: void arm(uint_type sid)
+	{
+		customer_container const& queue(servers_[sid]);
+		aggregated_server_state_type& state(states_[sid]);
+
+		if (state.rate <= 0)
+		{
+			// No work can be done
+			if (state.armed)
+			{
+				this->node().suspend_service(this->info(state.armed_key).get_customer());
+				state.armed = false;
+			}
+			return;
+		}
+
+		const ::std::size_t nc(queue.size());
+		info_key_type key(queue.front());
+		real_type delay(::std::numeric_limits<real_type>::infinity());
+		for (::std::size_t pos = 0; pos < nc; ++pos)
+		{
+			real_type d(completion_delay(state, nc, pos, this->info(queue[pos]).residual_work()));
+			if (d < delay)
+			{
+				delay = d;
+				key = queue[pos];
+			}
+		}
+
+		if (state.armed && state.armed_key != key)
+		{
+			this->node().suspend_service(this->info(state.armed_key).get_customer());
+		}
+
+		const real_type fire_time(state.last_update_time+delay);
+
+		// Avoid to reschedule events whose fire time is unchanged
+		if (!state.armed
+			|| state.armed_key != key
+			|| !::dcs::math::float_traits<real_type>::essentially_equal(fire_time, state.armed_fire_time))
+		{
+			this->node().reschedule_service(this->info(key).get_customer(), delay);
+		}
+
+		state.armed = true;
+		state.armed_key = key;
+		state.armed_fire_time = fire_time;
+	}
+
+
 	/// The quantum
 	private: real_type q_;
 	/// The total number of servers.
@@ -690,12 +1060,18 @@ class rr_service_strategy: public base_service_strategy<TraitsT>
 	private: uint_type num_busy_;
 	/// The next server used to assign a new customer.
 	private: uint_type next_srv_;
+	/// The number of customers of each server, indexed for least-loaded server selection.
+	private: ::dcs::des::detail::server_load_index<uint_type> loads_;
 	/// Source for QUANTUM-EXCEEDED events.
 	private: event_source_pointer ptr_quantum_expiry_evt_src_;
 	/// Hold <server-id,quantum-event-pointer> associations
 	private: server_event_map srv_evt_map_;
 	private: real_type old_share_;//FIXME: experimental
 	private: real_type old_multiplier_;//FIXME: experimental
+	/// Tell if quanta are aggregated.
+	private: bool aggregate_;
+	/// The state of the servers when quanta are aggregated.
+	private: aggregated_server_state_container states_;
 
 	//@} Data members
 };
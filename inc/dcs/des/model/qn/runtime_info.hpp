@@ -31,6 +31,7 @@
 
 #include <boost/smart_ptr.hpp>
 #include <dcs/debug.hpp>
+#include <dcs/des/detail/slot_map.hpp>
 #include <dcs/des/model/qn/server_utilization_profile.hpp>
 #include <dcs/des/model/qn/customer.hpp>
 #include <dcs/math/traits/float.hpp>
@@ -48,6 +49,7 @@ class runtime_info
 	public: typedef server_utilization_profile<real_type> utilization_profile_type;
 	public: typedef customer<traits_type> customer_type;
 	public: typedef ::boost::shared_ptr<customer_type> customer_pointer;
+	public: typedef ::dcs::des::detail::slot_map_key server_key_type;
 
 
 	public: runtime_info()
@@ -58,7 +60,8 @@ class runtime_info
 	  lwut_(st_),
 	  share_(1),
 	  mult_(1),
-	  sid_(0)
+	  sid_(0),
+	  skey_()
 	{
 	}
 
@@ -70,7 +73,8 @@ class runtime_info
 	  lwut_(st_),
 	  share_(1),
 	  mult_(1),
-	  sid_(0)
+	  sid_(0),
+	  skey_()
 	{
 	}
 
@@ -82,7 +86,8 @@ class runtime_info
 	  lwut_(st_),
 	  share_(1),
 	  mult_(1),
-	  sid_(0)
+	  sid_(0),
+	  skey_()
 	{
 	}
 
@@ -198,6 +203,20 @@ DCS_DEBUG_TRACE("(" << this << ") Accumulating work for Customer: " << ::std::se
 	}
 
 
+	/// Set the key of the customer in the container of the customers of its
+	/// server (for service strategies that keep one).
+	public: void server_key(server_key_type const& key)
+	{
+		skey_ = key;
+	}
+
+
+	public: server_key_type const& server_key() const
+	{
+		return skey_;
+	}
+
+
 	public: customer_type const& get_customer() const
 	{
 		return *ptr_customer_;
@@ -264,6 +283,8 @@ DCS_DEBUG_TRACE("(" << this << ") Accumulating work for Customer: " << ::std::se
 	private: real_type mult_;
 	/// The current server ID.
 	private: uint_type sid_;
+	/// The key of the customer in the container of its server.
+	private: server_key_type skey_;
 //	private: utilization_profile_type u_prof_;
 };
 
@@ -39,7 +39,7 @@
 #include <dcs/des/model/qn/network_node.hpp>
 #include <dcs/des/model/qn/network_node_category.hpp>
 #include <dcs/macro.hpp>
-#include <map>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -70,7 +70,17 @@ class service_station_node: public network_node<TraitsT>
 	public: typedef ::boost::shared_ptr<routing_strategy_type> routing_strategy_pointer;
 	private: typedef typename service_strategy_type::runtime_info_type runtime_info_type;
 	private: typedef ::boost::shared_ptr<event_type> event_pointer;
-	private: typedef ::std::map<uint_type,event_pointer> customer_event_map;
+	private: typedef typename service_strategy_type::info_key_type info_key_type;
+	/// The end-of-service event of a customer, along with the key of the
+	/// customer in service, used to detect stale or recycled keys.
+	private: struct customer_event
+	{
+		event_pointer ptr_evt;
+		info_key_type key;
+	};
+	/// Indexed by the slot of the runtime information of the customers in
+	/// service (see customer::service_key).
+	private: typedef ::std::vector<customer_event> customer_event_container;
 
 
 	private: static const ::std::string service_event_source_name;
@@ -260,12 +270,25 @@ class service_station_node: public network_node<TraitsT>
 	}
 
 
+	/**
+	 * \brief Change the time of the end-of-service of the given customer to
+	 *  the current time plus \a delay.
+	 *
+	 * If the end-of-service event of the customer has been suspended (see
+	 * \c suspend_service), it is scheduled again.
+	 */
 	public: void reschedule_service(customer_type customer, real_type delay)
 	{
 		DCS_DEBUG_TRACE_L(3, "(" << this << ") BEGIN Rescheduling Service for  Customer: " << customer);///XXX
 
-		event_pointer ptr_evt(cust_evt_map_.at(customer.id()));
-			
+		event_pointer& ptr_evt(service_event(customer));
+
+		// check: the service event source may have been disabled
+		if (!ptr_evt)
+		{
+			return;
+		}
+
 		// check: paranoid check
 		DCS_DEBUG_ASSERT( customer.id() == (*ptr_evt).template unfolded_state<customer_pointer>()->id() );
 
@@ -273,29 +296,76 @@ class service_station_node: public network_node<TraitsT>
 
 		DCS_DEBUG_TRACE_L(3, "(" << this << ") Old Fire-Time: " << ptr_evt->fire_time() << " --> New Fire-Time: " << fire_time);///XXX
 
-		this->network().engine().reschedule_event(ptr_evt, fire_time);
+		if (ptr_evt->scheduled())
+		{
+			this->network().engine().reschedule_event(ptr_evt, fire_time);
+		}
+		else
+		{
+			// The event has been suspended: schedule a new one
+			event_pointer ptr_new_evt(
+				this->network().engine().schedule_event(
+					ptr_srv_evt_src_,
+					fire_time,
+					(*ptr_evt).template unfolded_state<customer_pointer>()
+				)
+			);
+			if (ptr_new_evt)
+			{
+				ptr_evt = ptr_new_evt;
+			}
+		}
 
 		DCS_DEBUG_TRACE_L(3, "(" << this << ") END Rescheduling Service for  Customer: " << customer);///XXX
 	}
 
 
+	/**
+	 * \brief Remove the end-of-service event of the given customer from the
+	 *  event list, without removing the customer from service.
+	 *
+	 * The event can be scheduled again by means of \c reschedule_service.
+	 * This is useful for service strategies that only keep the next
+	 * completion in the event list.
+	 */
+	public: void suspend_service(customer_type const& customer)
+	{
+		DCS_DEBUG_TRACE_L(3, "(" << this << ") BEGIN Suspending Service for  Customer: " << customer);///XXX
+
+		event_pointer ptr_evt(service_event(customer));
+
+		if (ptr_evt)
+		{
+			// check: paranoid check
+			DCS_DEBUG_ASSERT( customer.id() == (*ptr_evt).template unfolded_state<customer_pointer>()->id() );
+
+			this->network().engine().cancel_event(ptr_evt);
+		}
+
+		DCS_DEBUG_TRACE_L(3, "(" << this << ") END Suspending Service for  Customer: " << customer);///XXX
+	}
+
+
 	public: ::std::vector<customer_pointer> active_customers() const
 	{
-		typedef typename customer_event_map::const_iterator iterator;
+		typedef typename customer_event_container::const_iterator iterator;
 
 		//update_state();
 		//const_cast<self_type*>(this)->update_state();
 
 		::std::vector<customer_pointer> customers;
 
-		iterator evt_end_it(cust_evt_map_.end());
-		for (iterator it = cust_evt_map_.begin(); it != evt_end_it; ++it)
+		iterator evt_end_it(cust_evts_.end());
+		for (iterator it = cust_evts_.begin(); it != evt_end_it; ++it)
 		{
-			event_pointer ptr_evt(it->second);
-			customer_pointer ptr_customer((*ptr_evt).template unfolded_state<customer_pointer>());
+			event_pointer ptr_evt(it->ptr_evt);
+
+			if (!ptr_evt)
+			{
+				continue;
+			}
 
-			// check: double check
-			DCS_DEBUG_ASSERT( it->first == ptr_customer->id() );
+			customer_pointer ptr_customer((*ptr_evt).template unfolded_state<customer_pointer>());
 
 			customers.push_back(ptr_customer);
 		}
@@ -344,7 +414,17 @@ class service_station_node: public network_node<TraitsT>
 				this->network().engine().simulated_time()+delay,
 				ptr_customer
 		);
-		cust_evt_map_[ptr_customer->id()] = ptr_evt;//[sguazt] EXP
+		const info_key_type key(ptr_customer->service_key());
+		if (key.index >= cust_evts_.size())
+		{
+			cust_evts_.resize(key.index+1);
+		}
+		cust_evts_[key.index].ptr_evt = ptr_evt;//[sguazt] EXP
+		cust_evts_[key.index].key = key;
+		if (ptr_evt)
+		{
+			ptr_srv_->service_scheduled(*ptr_customer);
+		}
 //		ptr_srv_->info(ptr_customer).start_time(this->network().engine().simulated_time());//EXP
 
 		DCS_DEBUG_TRACE_L(3, "(" << this << ") END Scheduling SERVICE for Customer at Node " << *this << " for Customer " << *ptr_customer << " with Delay " << delay << " (Clock: " << this->network().engine().simulated_time() << ")"); //XXX
@@ -385,7 +465,7 @@ class service_station_node: public network_node<TraitsT>
 		base_type::do_initialize_experiment();
 
 		ptr_srv_->reset();
-		cust_evt_map_.clear();//[sguazt] EXP
+		cust_evts_.clear();//[sguazt] EXP
 	}
 
 
@@ -393,21 +473,24 @@ class service_station_node: public network_node<TraitsT>
 	{
 		base_type::do_finalize_experiment();
 
-		typedef typename customer_event_map::iterator customer_event_iterator;
-		customer_event_iterator evt_end_it(cust_evt_map_.end());
-		for (customer_event_iterator it = cust_evt_map_.begin(); it != evt_end_it; ++it)
+		typedef typename customer_event_container::iterator customer_event_iterator;
+		customer_event_iterator evt_end_it(cust_evts_.end());
+		for (customer_event_iterator it = cust_evts_.begin(); it != evt_end_it; ++it)
 		{
-			event_pointer ptr_evt(it->second);
-			customer_pointer ptr_customer((*ptr_evt).template unfolded_state<customer_pointer>());
+			event_pointer ptr_evt(it->ptr_evt);
 
-			// check: paranoid check
-			DCS_DEBUG_ASSERT( it->first == ptr_customer->id() );
+			if (!ptr_evt)
+			{
+				continue;
+			}
+
+			customer_pointer ptr_customer((*ptr_evt).template unfolded_state<customer_pointer>());
 
 			ptr_customer->status(customer_type::node_killed_status);
 		}
 
 		ptr_srv_->remove_all();
-		cust_evt_map_.clear();
+		cust_evts_.clear();
 	}
 
 
@@ -528,7 +611,7 @@ class service_station_node: public network_node<TraitsT>
 
 		// ... And remove it from service
 		ptr_srv_->remove(ptr_customer);
-		cust_evt_map_.erase(ptr_customer->id());//[sguazt] EXP
+		service_event(*ptr_customer).reset();//[sguazt] EXP
 
 		this->last_event_time(ctx.simulated_time());
 
@@ -541,10 +624,25 @@ class service_station_node: public network_node<TraitsT>
 	private: virtual void do_process_service(customer_pointer const& ptr_customer, engine_context_type& ctx) = 0;
 
 
+	/// Return the end-of-service event of the given customer.
+	private: event_pointer& service_event(customer_type const& customer)
+	{
+		const info_key_type key(customer.service_key());
+
+		// pre: customer must be in service at this node
+		DCS_ASSERT(
+			key.index < cust_evts_.size() && cust_evts_[key.index].key == key,
+			throw ::std::out_of_range("[dcs::des::model::qn::service_station_node::service_event] Customer not in service.")
+		);
+
+		return cust_evts_[key.index].ptr_evt;
+	}
+
+
 	private: service_strategy_pointer ptr_srv_;
 	private: routing_strategy_pointer ptr_route_;
 	private: event_source_pointer ptr_srv_evt_src_;
-	private: customer_event_map cust_evt_map_;
+	private: customer_event_container cust_evts_;
 	private: real_type last_state_update_time_;
 };
 
@@ -0,0 +1,45 @@
+/**
+ * \file dcs/des/model/qn/visit_history_policy.hpp
+ *
+ * \brief Policies for recording the visits of customers to nodes.
+ *
+ * Copyright (C) 2012       Distributed Computing System (DCS) Group,
+ *                          Computer Science Institute,
+ *                          Department of Science and Technological Innovation,
+ *                          University of Piemonte Orientale,
+ *                          Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_MODEL_QN_VISIT_HISTORY_POLICY_HPP
+#define DCS_DES_MODEL_QN_VISIT_HISTORY_POLICY_HPP
+
+
+namespace dcs { namespace des { namespace model { namespace qn {
+
+/// Policies for recording the visits of a customer to the nodes.
+enum visit_history_policy
+{
+	no_visit_history, ///< Only the arrival time of the latest visit is recorded.
+	last_visit_history, ///< The last visit to each node is recorded.
+	full_visit_history ///< Every visit to each node is recorded.
+};
+
+}}}} // Namespace dcs::des::model::qn
+
+
+#endif // DCS_DES_MODEL_QN_VISIT_HISTORY_POLICY_HPP
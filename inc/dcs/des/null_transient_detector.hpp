@@ -30,6 +30,7 @@
 
 
 #include <cstddef>
+#include <dcs/des/sample_range.hpp>
 #include <utility>
 #include <vector>
 
@@ -42,7 +43,7 @@ class null_transient_detector
 	public: typedef RealT real_type;
 	public: typedef UIntT uint_type;
 	public: typedef ::std::pair<real_type,real_type> sample_type;
-	public: typedef ::std::vector<sample_type> sample_container;
+	public: typedef sample_range<real_type> sample_range_type;
 
 
 	private: static const uint_type transient_size_ = 0;
@@ -56,7 +57,8 @@ class null_transient_detector
 
 	public: bool detect(real_type obs, real_type weight)
 	{
-		obs_.push_back(::std::make_pair(obs, weight));
+		obs_.push_back(obs);
+		weights_.push_back(weight);
 
 		return true;
 	}
@@ -83,16 +85,24 @@ class null_transient_detector
 	public: void reset()
 	{
 		obs_.clear();
+		weights_.clear();
 	}
 
 
-	public: sample_container steady_state_observations() const
+	/// Return a view of the observations collected since the last reset.
+	public: sample_range_type steady_state_observations() const
 	{
-		return obs_;
+		if (obs_.empty())
+		{
+			return sample_range_type();
+		}
+
+		return sample_range_type(&obs_[0], &weights_[0], obs_.size());
 	}
 
 
-	private: sample_container obs_;
+	private: ::std::vector<real_type> obs_;
+	private: ::std::vector<real_type> weights_;
 };
 
 }} // Namespace dcs::des
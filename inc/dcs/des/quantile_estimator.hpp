@@ -34,9 +34,9 @@
 #include <boost/accumulators/statistics/p_square_quantile.hpp>
 #include <boost/accumulators/statistics/stats.hpp>
 #include <dcs/des/base_statistic.hpp>
+#include <dcs/des/detail/quantile_cache.hpp>
 #include <dcs/des/statistic_categories.hpp>
 #include <dcs/math/constants.hpp>
-#include <dcs/math/stats/distribution/students_t.hpp>
 #include <sstream>
 #include <string>
 
@@ -139,8 +139,7 @@ class quantile_estimator: public base_statistic<ValueT,UIntT>
 		if (this->num_observations() > 1)
 		{
 			uint_type n(this->num_observations());
-			::dcs::math::stats::students_t_distribution<value_type> t_dist(n-1);
-			value_type t(::dcs::math::stats::quantile(t_dist, (1+this->confidence_interval())/value_type(2)));
+			value_type t(detail::students_t_quantile(n-1, (1+this->confidence_interval())/value_type(2)));
 			value_type q(this->estimate());
 
 			return t*::std::sqrt(q*(1-q)/(this->num_observations()-1));
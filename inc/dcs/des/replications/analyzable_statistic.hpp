@@ -32,12 +32,15 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <dcs/assert.hpp>
 #include <dcs/debug.hpp>
 #include <dcs/des/base_analyzable_statistic.hpp>
 #include <dcs/des/engine_traits.hpp>
+#include <dcs/des/event_firing_hooks.hpp>
 #include <dcs/des/mean_estimator.hpp>
 //#include <dcs/des/replications/engine.hpp>
+#include <dcs/des/replications/replication_size_detector_traits.hpp>
 #include <dcs/des/statistic_categories.hpp>
 #include <dcs/functional/bind.hpp>
 #include <dcs/macro.hpp>
@@ -51,7 +54,7 @@
 
 namespace dcs { namespace des { namespace replications {
 
-template <typename RealT, typename UIntT>
+template <typename RealT, typename UIntT, typename FiringHooksT>
 class engine;
 
 
@@ -63,6 +66,8 @@ class engine;
  * \tparam TransientDetectorT The type of the transient phase detector.
  * \tparam ReplicationSizeDetectorT The type of the replication size detector.
  * \tparam NumReplicationsDetectorT The type of the replication size detector.
+ * \tparam FiringHooksT The firing-hooks policy of the simulation engine (see
+ *  \c with_event_firing_hooks and \c without_event_firing_hooks).
  *
  * \author Marco Guazzone (marco.guazzone@gmail.com)
  */
@@ -70,14 +75,15 @@ template <
 	typename StatisticT,
 	typename TransientDetectorT,
 	typename ReplicationSizeDetectorT,
-	typename NumReplicationsDetectorT
+	typename NumReplicationsDetectorT,
+	typename FiringHooksT = with_event_firing_hooks
 >
 class analyzable_statistic: public base_analyzable_statistic<
 										typename StatisticT::value_type,
 										typename StatisticT::uint_type
 									>
 {
-	private: typedef analyzable_statistic<StatisticT,TransientDetectorT,ReplicationSizeDetectorT,NumReplicationsDetectorT> self_type;
+	private: typedef analyzable_statistic<StatisticT,TransientDetectorT,ReplicationSizeDetectorT,NumReplicationsDetectorT,FiringHooksT> self_type;
 	public: typedef StatisticT statistic_type;
 	public: typedef typename statistic_type::value_type value_type;
 	public: typedef typename statistic_type::uint_type uint_type;
@@ -86,7 +92,7 @@ class analyzable_statistic: public base_analyzable_statistic<
 	public: typedef NumReplicationsDetectorT num_replications_detector_type;
 //	public: typedef typename statistic_type::category_type category_type;
 	private: typedef base_analyzable_statistic<value_type,uint_type> base_type;
-	private: typedef ::dcs::des::replications::engine<value_type,uint_type> engine_type;
+	private: typedef ::dcs::des::replications::engine<value_type,uint_type,FiringHooksT> engine_type;
 	private: typedef typename ::dcs::des::engine_traits<engine_type>::event_type event_type;
 	private: typedef typename ::dcs::des::engine_traits<engine_type>::engine_context_type engine_context_type;
 
@@ -139,7 +145,7 @@ class analyzable_statistic: public base_analyzable_statistic<
 							 transient_phase_detector_type const& transient_detector,
 							 replication_size_detector_type const& repl_size_detector,
 							 num_replications_detector_type const& num_repl_detector,
-							 ::dcs::des::replications::engine<RealT,UIntT>& eng,
+							 ::dcs::des::replications::engine<RealT,UIntT,FiringHooksT>& eng,
 							 value_type relative_precision = base_type::default_target_relative_precision,
 							 uint_type max_num_obs = default_max_num_obs,
 							 uint_type min_num_repl = default_min_num_repl)
@@ -345,6 +351,9 @@ class analyzable_statistic: public base_analyzable_statistic<
 		if (repl_size_detected_)
 		{
 			stat_(obs, weight);
+
+			// Only the completion of the replication may have changed
+			this->notify_completion_change();
 		}
 		else if (trans_detected_)
 		{
@@ -355,6 +364,11 @@ class analyzable_statistic: public base_analyzable_statistic<
 			repl_size_detected_ = repl_size_detector_.detect(obs, weight);
 
 			this->replication_size_detection();
+
+			if (repl_size_detected_)
+			{
+				this->notify_state_change();
+			}
 		}
 		else
 		{
@@ -365,12 +379,55 @@ class analyzable_statistic: public base_analyzable_statistic<
 			trans_detected_ = trans_detector_.detect(obs, weight);
 
 			this->transient_detection();
+
+			if (trans_detected_)
+			{
+				this->notify_state_change();
+			}
 		}
 
 		DCS_DEBUG_TRACE("(" << this << ") END Collecting observation " << obs << " - weight: " << weight);
 	}
 
 
+	/**
+	 * \brief Collect a block of observations.
+	 *
+	 * Once the replication size is known, the observations are passed in a
+	 * single step to the underlying statistic; before, they are collected
+	 * one at a time.
+	 */
+	private: void do_collect_block(value_type const* obs, value_type const* weights, ::std::size_t n)
+	{
+		::std::size_t i(0);
+		while (i < n)
+		{
+			if (repl_size_detected_)
+			{
+				// The observations that can be collected before the maximum
+				// number of observations is reached
+				::std::size_t m(n-i);
+				if (max_num_obs_ != base_type::num_observations_infinity)
+				{
+					const uint_type num_obs(stat_.num_observations());
+					m = ::std::min(m, static_cast< ::std::size_t >(max_num_obs_ > num_obs ? max_num_obs_-num_obs : 0));
+				}
+				if (m > 0)
+				{
+					stat_.collect(obs+i, weights ? weights+i : 0, m);
+					i += m;
+
+					this->notify_completion_change();
+					continue;
+				}
+			}
+
+			do_collect(obs[i], weights ? weights[i] : value_type(1));
+			++i;
+		}
+	}
+
+
 	private: void transient_detection()
 	{
 		DCS_DEBUG_TRACE("(" << this << ") Handling detection of transient phase...");
@@ -392,27 +449,19 @@ class analyzable_statistic: public base_analyzable_statistic<
 			// Transient phase just detected
 			// Put back steady-state observations possibly used for
 			// transient phase detection
-			typedef typename transient_phase_detector_type::sample_container vector_type;
-			typedef typename vector_type::const_iterator vector_iterator_type;
-
-			vector_type obss = trans_detector_.steady_state_observations();
-			vector_iterator_type obss_end = obss.end();
-
-			for (
-				vector_iterator_type it = obss.begin();
-				it != obss_end;
-				++it
-			) {
-				// Recursively call this method in order to collect
-				// observations for replication size detection or for
-				// sample accumulation
-				this->operator()(it->first, it->second);
-			}
+			// Note: the observations are replayed from a view of the buffer
+			// of the transient detector, which is left untouched until it is
+			// reset.
+			// Recursively collect the observations for replication size
+			// detection or for sample accumulation
+			this->collect(trans_detector_.steady_state_observations());
 
 			DCS_DEBUG_TRACE("(" << this << ") Safe steady-state observations put back.");
 
 			// Reset transient detector to save memory
 			trans_detector_.reset();
+
+			this->notify_state_change();
 		}
 		else if (trans_detector_.aborted())
 		{
@@ -469,6 +518,8 @@ class analyzable_statistic: public base_analyzable_statistic<
 			// Reset replication size detector to save memory
 			repl_size_detector_.reset();
 
+			this->notify_state_change();
+
 //					// Adjust max number of observation so that to take the
 //					// minimum between the value set by the user and the value
 //					// obtained from replication size detector.
@@ -634,6 +685,8 @@ class analyzable_statistic: public base_analyzable_statistic<
 			num_repl_ = ::std::max(min_num_repl_, num_repl_detector_.estimated_number());
 		}
 		this->enable(true);
+
+		this->notify_state_change();
 	}
 
 
@@ -672,6 +725,19 @@ class analyzable_statistic: public base_analyzable_statistic<
 	}
 
 
+	private: bool do_time_dependent() const
+	{
+		return replication_size_detector_traits<replication_size_detector_type>::time_dependent;
+	}
+
+
+	private: void do_time_advanced()
+	{
+		// Notifications are only sent on detection (see replication_size_detection)
+		replication_size_detection();
+	}
+
+
 	private: void do_refresh()
 	{
 //::std::cerr << "[replications::analyzable_statistic] (" << this << ") BEGIN REFRESH - repl-size-detector: <" << repl_size_detector_.print() << "> - repl_size_detected_: " << repl_size_detected_ << " - repl_size_: " << repl_size_ << ::std::endl;///XXX
@@ -747,9 +813,10 @@ template <
 	typename StatisticT,
 	typename TransientDetectorT,
 	typename ReplicationSizeDetectorT,
-	typename NumReplicationsDetectorT
+	typename NumReplicationsDetectorT,
+	typename FiringHooksT
 >
-const typename StatisticT::uint_type analyzable_statistic<StatisticT,TransientDetectorT,ReplicationSizeDetectorT,NumReplicationsDetectorT>::default_max_num_obs = base_analyzable_statistic<typename StatisticT::value_type,typename StatisticT::uint_type>::num_observations_infinity;
+const typename StatisticT::uint_type analyzable_statistic<StatisticT,TransientDetectorT,ReplicationSizeDetectorT,NumReplicationsDetectorT,FiringHooksT>::default_max_num_obs = base_analyzable_statistic<typename StatisticT::value_type,typename StatisticT::uint_type>::num_observations_infinity;
 
 }}} // Namespace dcs::des::replications
 
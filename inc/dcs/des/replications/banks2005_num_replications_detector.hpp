@@ -36,11 +36,10 @@
 #define DCS_DES_REPLICATIONS_BANKS2005_NUM_REPLICATIONS_DETECTOR_HPP
 
 
-#include <boost/math/distributions/normal.hpp>
-#include <boost/math/distributions/students_t.hpp>
 #include <cmath>
 #include <cstddef>
 #include <dcs/assert.hpp>
+#include <dcs/des/detail/quantile_cache.hpp>
 #include <dcs/exception.hpp>
 #include <dcs/logging.hpp>
 #include <dcs/macro.hpp>
@@ -126,8 +125,7 @@ class banks2005_num_replications_detector
 		{
 			first_call_ = false;
 
-			::boost::math::normal_distribution<real_type> norm;
-			const real_type z = ::boost::math::quantile(norm, half_alpha);
+			const real_type z = ::dcs::des::detail::normal_quantile(half_alpha);
 			r_ =  static_cast<uint_type>(::dcs::math::sqr(z*stddev/(rel_prec_*estimate)));
 
 			if (r_ < r_min_)
@@ -136,21 +134,19 @@ class banks2005_num_replications_detector
 			}
 		}
 
-		real_type r_want = 0;
-
-		// Compute the real estimate of R
-		do
+		// Compute the real estimate of R, that is the smallest R (not less
+		// than the current one) such that R >= (t_{R-1}*stddev/(rel_prec*estimate))^2
+		// Note: t_{R-1} is computed at 1-alpha/2 (instead of alpha/2) since
+		//       only its square is needed.
+		const real_type c = stddev/(rel_prec_*estimate);
+		if (r_ < r_max_)
 		{
-			::boost::math::students_t_distribution<real_type> student_t(r_-1);
-			const real_type t = ::boost::math::quantile(student_t, half_alpha);
-			r_want = ::dcs::math::sqr(t*stddev/(rel_prec_*estimate));
-
-			if (r_ < r_want)
-			{
-				++r_;
-			}
+			r_ = ::dcs::des::detail::students_t_sample_size(c, 1-half_alpha, r_, r_max_);
+		}
+		else if (!::dcs::des::detail::students_t_sample_size_ok(::dcs::des::detail::shared_quantile_cache<real_type>(), c, 1-half_alpha, r_))
+		{
+			++r_;
 		}
-		while (r_ < r_want && r_ < r_max_);
 
 		if (r_ <= r_max_)
 		{
@@ -163,7 +159,7 @@ class banks2005_num_replications_detector
 			aborted_ = true;
 		}
 
-DCS_DEBUG_TRACE("(" << this << ") Detecting Sample Size --> " << ::std::boolalpha << detected_ << " (r_: " << r_ << " - r_want: " << r_want << " - r_max_: " << r_max_ << " - aborted_: " << aborted_ << ")");//XXX
+DCS_DEBUG_TRACE("(" << this << ") Detecting Sample Size --> " << ::std::boolalpha << detected_ << " (r_: " << r_ << " - r_max_: " << r_max_ << " - aborted_: " << aborted_ << ")");//XXX
 
 		return detected_;
 	}
@@ -39,6 +39,7 @@
 #include <dcs/des/replications/dummy_num_replications_detector.hpp>
 #include <dcs/des/replications/dummy_replication_size_detector.hpp>
 #include <dcs/des/engine.hpp>
+#include <dcs/des/event_firing_hooks.hpp>
 #include <dcs/des/null_transient_detector.hpp>
 #include <dcs/des/output_analysis.hpp>
 #include <dcs/des/output_analysis_categories.hpp>
@@ -56,11 +57,22 @@ namespace dcs { namespace des {
 
 namespace replications {
 
-template <typename RealT, typename UIntT = std::size_t>
+/**
+ * \brief Discrete-event simulator engine with output analysis based on the
+ *  Independent Replications method.
+ *
+ * \tparam RealT The type used for real numbers.
+ * \tparam UIntT The type used for positive integral numbers.
+ * \tparam FiringHooksT The policy for the BEFORE/AFTER-EVENT-FIRING events
+ *  (see \c with_event_firing_hooks and \c without_event_firing_hooks).
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename RealT, typename UIntT = std::size_t, typename FiringHooksT = with_event_firing_hooks>
 class engine: public ::dcs::des::engine<RealT>
 {
 	private: typedef ::dcs::des::engine<RealT> base_type;
-	private: typedef engine<RealT,UIntT> self_type;
+	private: typedef engine<RealT,UIntT,FiringHooksT> self_type;
 //	public: typedef TransientPhaseDetectorT transient_phase_detector_type;
 //	public: typedef ReplicationSizeDetectorT replication_size_detector_type;
 //	public: typedef NumReplicationsDetectorT num_replications_detector_type;
@@ -216,17 +228,9 @@ class engine: public ::dcs::des::engine<RealT>
 	}
 
 
-	protected: bool is_internal_event(event_type const& evt) const
-	{
-		return base_type::is_internal_event(evt)
-			   || evt.source() == *ptr_bor_evt_src_
-			   || evt.source() == *ptr_eor_evt_src_;
-	}
-
-
 	protected: void monitor_statistics_in_replication()
 	{
-		typedef typename base_type::analyzable_statistic_const_iterator stat_iterator;
+		typedef typename base_type::time_dependent_statistic_container::const_iterator stat_iterator;
 
 		DCS_DEBUG_TRACE_L(1, "(" << this << ") BEGIN Monitoring statistics in replication."); //XXX
 
@@ -235,28 +239,22 @@ class engine: public ::dcs::des::engine<RealT>
 			return;
 		}
 
-		// NOTE: Current replication is done only when *all* of the monitored stats
-		//       are "complete".
-
-		bool replication_done(true);
-		stat_iterator end_it(this->monitored_statistics().end());
+		// Only the statistics whose state may change with the simulated time
+		// need to be updated here; the other ones notify this engine when
+		// their state changes.
+		stat_iterator end_it(this->time_dependent_statistics().end());
 		for (
-			stat_iterator it = this->monitored_statistics().begin();
+			stat_iterator it = this->time_dependent_statistics().begin();
 			it != end_it;
 			++it
 		) {
-			analyzable_statistic_pointer ptr_stat(it->first);
-
-			ptr_stat->refresh();
-
-			if (ptr_stat->enabled() && !ptr_stat->observation_complete())
-			{
-				replication_done = false;
-				break;
-			}
+			(*it)->time_advanced();
 		}
 
-		if (replication_done)
+		// NOTE: Current replication is done only when *all* of the monitored stats
+		//       are "complete" (or disabled).
+
+		if (this->num_incomplete_statistics() == 0)
 		{
 			end_of_repl_ = true;
 		}
@@ -265,6 +263,30 @@ class engine: public ::dcs::des::engine<RealT>
 	}
 
 
+	protected: void prepare_simulation(engine_context_type& ctx)
+	{
+		base_type::template prepare_simulation<FiringHooksT>(ctx);
+	}
+
+
+	protected: void finalize_simulation(engine_context_type& ctx)
+	{
+		base_type::template finalize_simulation<FiringHooksT>(ctx);
+	}
+
+
+	protected: void initialize_simulated_system(engine_context_type& ctx)
+	{
+		base_type::template initialize_simulated_system<FiringHooksT>(ctx);
+	}
+
+
+	protected: void finalize_simulated_system(engine_context_type& ctx)
+	{
+		base_type::template finalize_simulated_system<FiringHooksT>(ctx);
+	}
+
+
 	protected: void prepare_replication(engine_context_type& ctx)
 	{
 		end_of_repl_ = false;
@@ -277,7 +299,7 @@ class engine: public ::dcs::des::engine<RealT>
 //		// ... and immediately fire it
 //		this->fire_next_event(ctx);
 		// Immediately (schedule and) fire the BEGIN-OF-REPLICATION event
-		this->fire_immediate_event(ptr_bor_evt_src_, ctx, repl_count_);
+		this->template fire_immediate_event<FiringHooksT>(ptr_bor_evt_src_, ctx, repl_count_);
 
 //		if (this->monitored_statistics().empty())
 //		{
@@ -298,7 +320,7 @@ class engine: public ::dcs::des::engine<RealT>
 //		// ... and immediately fire it
 //		fire_next_event(ctx);
 		// Immediately (schedule and) fire the END-OF-REPLICATION event
-		this->fire_immediate_event(ptr_eor_evt_src_, ctx, repl_count_);
+		this->template fire_immediate_event<FiringHooksT>(ptr_eor_evt_src_, ctx, repl_count_);
 //		end_of_repl_ = true;
 //
 //		// Clear the replication state
@@ -327,6 +349,10 @@ class engine: public ::dcs::des::engine<RealT>
 
 	private: void init()
 	{
+		// BEGIN/END-OF-REPLICATION events are not user events
+		ptr_bor_evt_src_->internal(true);
+		ptr_eor_evt_src_->internal(true);
+
 		ptr_bor_evt_src_->connect(
 			::dcs::functional::bind(
 				&self_type::process_begin_of_replication,
@@ -377,7 +403,7 @@ class engine: public ::dcs::des::engine<RealT>
 			{
 				DCS_DEBUG_TRACE_L(1,  "Simulation time: " << this->simulated_time() );
 
-				this->fire_next_event(ctx);
+				this->template fire_next_event<FiringHooksT>(ctx);
 
 				// Monitor statistics
 				monitor_statistics_in_replication();
@@ -464,7 +490,8 @@ class engine: public ::dcs::des::engine<RealT>
 		typedef analyzable_statistic<statistic_type,
 									 transient_detector_type,
 									 replication_size_detector_type,
-									 num_replications_detector_type> analyzable_statistic_impl_type;
+									 num_replications_detector_type,
+									 FiringHooksT> analyzable_statistic_impl_type;
 
 //FIXME: don't compile since assume *this as a const reference
 //		return ::boost::make_shared<analyzable_statistic_impl_type>(
@@ -614,8 +641,8 @@ class engine: public ::dcs::des::engine<RealT>
 }; // engine
 
 
-template <typename RealT, typename UIntT>
-const RealT engine<RealT,UIntT>::default_min_repl_duration = RealT(1);
+template <typename RealT, typename UIntT, typename FiringHooksT>
+const RealT engine<RealT,UIntT,FiringHooksT>::default_min_repl_duration = RealT(1);
 
 
 namespace /*<unnamed>*/ { namespace detail {
@@ -623,13 +650,15 @@ namespace /*<unnamed>*/ { namespace detail {
 template <
 	typename TransientDetectorT,
 	typename ReplicationSizeDetectorT,
-	typename NumReplicationsDetectorT
+	typename NumReplicationsDetectorT,
+	typename FiringHooksT = with_event_firing_hooks
 >
 struct output_analyzer
 {
 	typedef TransientDetectorT transient_detector_type;
 	typedef ReplicationSizeDetectorT replication_size_detector_type;
 	typedef NumReplicationsDetectorT num_replications_detector_type;
+	typedef FiringHooksT firing_hooks_type;
 };
 
 }} // Namespace <unnamed>::detail
@@ -647,14 +676,16 @@ template <
 //	typename UIntT,
 	typename TransientPhaseDetectorT,
 	typename ReplicationSizeDetectorT,
-	typename NumReplicationsDetectorT
+	typename NumReplicationsDetectorT,
+	typename FiringHooksT
 >
 struct make_analyzable_statistic_type<
 			StatisticT,
 			replications::detail::output_analyzer<
 				TransientPhaseDetectorT,
 				ReplicationSizeDetectorT,
-				NumReplicationsDetectorT
+				NumReplicationsDetectorT,
+				FiringHooksT
 			>//,
 //			replications::engine<RealT,UIntT>
 	>
@@ -663,7 +694,8 @@ struct make_analyzable_statistic_type<
 				StatisticT,
 				TransientPhaseDetectorT,
 				ReplicationSizeDetectorT,
-				NumReplicationsDetectorT
+				NumReplicationsDetectorT,
+				FiringHooksT
 			> type;
 };
 
@@ -678,7 +710,8 @@ template <
 	typename UIntT,
 	typename TransientPhaseDetectorT,
 	typename ReplicationSizeDetectorT,
-	typename NumReplicationsDetectorT
+	typename NumReplicationsDetectorT,
+	typename FiringHooksT
 >
 ::boost::shared_ptr<
 	typename make_analyzable_statistic_type<
@@ -686,7 +719,8 @@ template <
 		replications::detail::output_analyzer<
 			TransientPhaseDetectorT,
 			ReplicationSizeDetectorT,
-			NumReplicationsDetectorT
+			NumReplicationsDetectorT,
+			FiringHooksT
 		>//,
 //		replications::engine<
 //			RealT,
@@ -697,7 +731,7 @@ template <
 							TransientPhaseDetectorT const& transient_detector,
 							ReplicationSizeDetectorT const& repl_size_detector,
 							NumReplicationsDetectorT const& num_repl_detector,
-							replications::engine<RealT,UIntT>& des_engine,
+							replications::engine<RealT,UIntT,FiringHooksT>& des_engine,
 							RealT relative_precision,
 							UIntT max_obs)
 {
@@ -706,7 +740,8 @@ template <
 						replications::detail::output_analyzer<
 							TransientPhaseDetectorT,
 							ReplicationSizeDetectorT,
-							NumReplicationsDetectorT
+							NumReplicationsDetectorT,
+							FiringHooksT
 						>//,
 //						replications::engine<
 //							RealT,
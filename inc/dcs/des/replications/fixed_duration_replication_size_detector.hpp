@@ -32,6 +32,7 @@
 #include <boost/smart_ptr.hpp>
 #include <cstddef>
 #include <dcs/debug.hpp>
+#include <dcs/des/replications/replication_size_detector_traits.hpp>
 #include <dcs/math/constants.hpp>
 #include <utility>
 #include <vector>
@@ -161,6 +162,16 @@ class fixed_duration_replication_size_detector
 
 };
 
+
+/// Specialization of \c replication_size_detector_traits for replications of fixed length.
+template <typename RealT, typename UIntT, typename DesEngineT>
+struct replication_size_detector_traits< fixed_duration_replication_size_detector<RealT,UIntT,DesEngineT> >
+{
+	typedef fixed_duration_replication_size_detector<RealT,UIntT,DesEngineT> detector_type;
+	// The detection depends on the simulated time only
+	static const bool time_dependent = true;
+};
+
 }}} // Namespace dcs::des::replications
 
 
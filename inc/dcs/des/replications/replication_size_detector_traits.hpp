@@ -0,0 +1,58 @@
+/**
+ * \file dcs/des/replications/replication_size_detector_traits.hpp
+ *
+ * \brief Traits class for replication size detectors.
+ *
+ * Copyright (C) 2012       Distributed Computing System (DCS) Group,
+ *                          Computer Science Institute,
+ *                          Department of Science and Technological Innovation,
+ *                          University of Piemonte Orientale,
+ *                          Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_REPLICATIONS_REPLICATION_SIZE_DETECTOR_TRAITS_HPP
+#define DCS_DES_REPLICATIONS_REPLICATION_SIZE_DETECTOR_TRAITS_HPP
+
+
+namespace dcs { namespace des { namespace replications {
+
+/**
+ * \brief Traits class for replication size detectors.
+ *
+ * The \c time_dependent constant tells if the outcome of the detection may
+ * change as the simulated time advances, even when no observation is
+ * collected.
+ * Statistics using such a detector are refreshed by the simulation engine
+ * after each event, so detectors whose \c detected() member function does not
+ * only depend on the collected observations must specialize this class.
+ *
+ * \tparam DetectorT The type of the replication size detector.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename DetectorT>
+struct replication_size_detector_traits
+{
+	typedef DetectorT detector_type;
+	static const bool time_dependent = false;
+};
+
+}}} // Namespace dcs::des::replications
+
+
+#endif // DCS_DES_REPLICATIONS_REPLICATION_SIZE_DETECTOR_TRAITS_HPP
@@ -0,0 +1,139 @@
+/**
+ * \file dcs/des/sample_range.hpp
+ *
+ * \brief Non-owning view of a sequence of weighted observations.
+ *
+ * Copyright (C) 2012       Distributed Computing System (DCS) Group,
+ *                          Computer Science Institute,
+ *                          Department of Science and Technological Innovation,
+ *                          University of Piemonte Orientale,
+ *                          Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_SAMPLE_RANGE_HPP
+#define DCS_DES_SAMPLE_RANGE_HPP
+
+
+#include <cstddef>
+#include <dcs/debug.hpp>
+#include <utility>
+
+
+namespace dcs { namespace des {
+
+/**
+ * \brief Non-owning view of a sequence of weighted observations.
+ *
+ * Observations and weights are stored in two contiguous arrays owned by
+ * someone else (e.g., a transient phase detector); the view is only valid
+ * until the owner is modified.
+ *
+ * \tparam RealT The type used for real numbers.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename RealT>
+class sample_range
+{
+	public: typedef RealT real_type;
+	public: typedef ::std::size_t size_type;
+	public: typedef ::std::pair<real_type,real_type> sample_type;
+
+
+	/// Create an empty range.
+	public: sample_range()
+	: ptr_obs_(0),
+	  ptr_weights_(0),
+	  size_(0)
+	{
+		// empty
+	}
+
+
+	/// Create a range of \a n observations and related weights.
+	public: sample_range(real_type const* ptr_obs, real_type const* ptr_weights, size_type n)
+	: ptr_obs_(ptr_obs),
+	  ptr_weights_(ptr_weights),
+	  size_(n)
+	{
+		// empty
+	}
+
+
+	/// Return the \a i-th observation.
+	public: real_type observation(size_type i) const
+	{
+		// pre: i < size()
+		DCS_DEBUG_ASSERT( i < size_ );
+
+		return ptr_obs_[i];
+	}
+
+
+	/// Return the weight of the \a i-th observation.
+	public: real_type weight(size_type i) const
+	{
+		// pre: i < size()
+		DCS_DEBUG_ASSERT( i < size_ );
+
+		return ptr_weights_[i];
+	}
+
+
+	/// Return the \a i-th observation together with its weight.
+	public: sample_type operator[](size_type i) const
+	{
+		return ::std::make_pair(observation(i), weight(i));
+	}
+
+
+	/// Return a pointer to the (contiguous) observations.
+	public: real_type const* observations() const
+	{
+		return ptr_obs_;
+	}
+
+
+	/// Return a pointer to the (contiguous) weights.
+	public: real_type const* weights() const
+	{
+		return ptr_weights_;
+	}
+
+
+	public: size_type size() const
+	{
+		return size_;
+	}
+
+
+	public: bool empty() const
+	{
+		return size_ == 0;
+	}
+
+
+	private: real_type const* ptr_obs_;
+	private: real_type const* ptr_weights_;
+	private: size_type size_;
+};
+
+}} // Namespace dcs::des
+
+
+#endif // DCS_DES_SAMPLE_RANGE_HPP
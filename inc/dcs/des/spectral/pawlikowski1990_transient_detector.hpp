@@ -41,11 +41,14 @@
 #include <cstddef>
 #include <dcs/assert.hpp>
 #include <dcs/debug.hpp>
+#include <dcs/des/detail/quantile_cache.hpp>
+#include <dcs/des/detail/ring_buffer.hpp>
+#include <dcs/des/sample_range.hpp>
 #include <dcs/math/constants.hpp>
 #include <dcs/math/function/sqr.hpp>
-#include <dcs/math/stats/distribution/students_t.hpp>
 #include <stdexcept>
 #include <limits>
+#include <map>
 #include <utility>
 #include <vector>
 
@@ -80,6 +83,317 @@ RealT schruben_statistic(::boost::numeric::ublas::vector_expression<VectorT> con
 }
 
 
+/**
+ * \brief Incremental computation of the Schruben statistic over a sliding
+ *  window of observations.
+ *
+ * Denoting with \f$S_k\f$ the sum of the first \f$k\f$ observations of the
+ * window, with \f$n\f$ the window length and with \f$\bar{X}=S_n/n\f$, the
+ * numerator of the Schruben statistic (see schruben_statistic) is:
+ * \f[
+ *  \sum_{k=1}^n k\left(1-\frac{k}{n}\right)\left(\bar{X}-\frac{S_k}{k}\right)
+ *  = \bar{X}\frac{n^2-1}{6} - P + \frac{Q}{n}
+ * \f]
+ * where \f$P=\sum_{k=1}^n S_k\f$ and \f$Q=\sum_{k=1}^n k S_k\f$.
+ * Both \f$P\f$ and \f$Q\f$ are updated in constant time when an
+ * observation is appended to the window, and in \f$O(s)\f$ time when the
+ * \f$s\f$ oldest observations are removed from it.
+ *
+ * Since the statistic does not change when a constant is subtracted from all
+ * the observations, observations are centered on a reference value (e.g., a
+ * first estimate of their mean) to limit the cancellation among the terms
+ * above.
+ * To avoid the accumulation of rounding errors, the sums are recomputed from
+ * scratch once as many observations as the window length have been removed,
+ * that is at an amortized constant cost per observation.
+ */
+template <typename RealT>
+class schruben_statistic_accumulator
+{
+	public: typedef RealT real_type;
+	public: typedef ::std::size_t size_type;
+
+
+	public: schruben_statistic_accumulator()
+	: ref_(0),
+	  n_(0),
+	  s_(0),
+	  p_(0),
+	  q_(0),
+	  num_popped_(0)
+	{
+		// empty
+	}
+
+
+	/**
+	 * \brief Remove all the observations and center the next ones on the
+	 *  reference value \a ref.
+	 */
+	public: void reset(real_type ref = real_type(0))
+	{
+		ref_ = ref;
+		clear();
+	}
+
+
+	/// Append the observation \a x to the window.
+	public: void push(real_type x)
+	{
+		++n_;
+		s_ += x - ref_;
+		p_ += s_;
+		q_ += real_type(n_) * s_;
+	}
+
+
+	/**
+	 * \brief Remove the \a s oldest observations from the window.
+	 *
+	 * \param x The observations currently in the window, from the oldest to
+	 *  the newest.
+	 * \param s The number of observations to remove.
+	 */
+	public: void pop_front(real_type const* x, size_type s)
+	{
+		// pre: s <= size()
+		DCS_DEBUG_ASSERT( s <= n_ );
+
+		num_popped_ += s;
+		if (num_popped_ >= n_)
+		{
+			// Recompute the sums from scratch
+			const size_type n(n_-s);
+			clear();
+			for (size_type k = 0; k < n; ++k)
+			{
+				push(x[s+k]);
+			}
+			return;
+		}
+
+		// Sums of the removed prefix: s_s = S_s, sum_s = S_1+...+S_s and
+		// sum_ks = 1*S_1+...+s*S_s.
+		real_type s_s = 0;
+		real_type sum_s = 0;
+		real_type sum_ks = 0;
+		for (size_type k = 1; k <= s; ++k)
+		{
+			s_s += x[k-1] - ref_;
+			sum_s += s_s;
+			sum_ks += real_type(k) * s_s;
+		}
+
+		// The new prefix sums are S'_k = S_{k+s} - S_s, k=1,...,n-s
+		const real_type m(n_-s);
+		q_ = (q_ - sum_ks) - real_type(s) * (p_ - sum_s) - s_s * m * (m + 1) / real_type(2);
+		p_ = (p_ - sum_s) - m * s_s;
+		s_ -= s_s;
+		n_ -= s;
+	}
+
+
+	/**
+	 * \brief Return the Schruben statistic of the observations in the window
+	 *  for the given length \a n_v of the sequence used to estimate the
+	 *  variance \a var.
+	 */
+	public: template <typename UIntT>
+		real_type value(UIntT n_v, real_type var) const
+	{
+		const real_type n(n_);
+		const real_type mean(s_ / n);
+		const real_type sum1(mean * (n * n - real_type(1)) / real_type(6) - p_ + q_ / n);
+
+		return sum1 * ::std::sqrt(real_type(45)) / (n * ::std::sqrt(n * n_v * var));
+	}
+
+
+	/// Return the number of observations in the window.
+	public: size_type size() const
+	{
+		return n_;
+	}
+
+
+	private: void clear()
+	{
+		n_ = num_popped_
+		   = 0;
+		s_ = p_
+		   = q_
+		   = real_type(0);
+	}
+
+
+	/// The value the observations are centered on.
+	private: real_type ref_;
+	/// The number of observations in the window.
+	private: size_type n_;
+	/// The sum S_n of the (centered) observations.
+	private: real_type s_;
+	/// The sum P of the prefix sums.
+	private: real_type p_;
+	/// The weighted sum Q of the prefix sums.
+	private: real_type q_;
+	/// The number of observations removed since the sums were last recomputed.
+	private: size_type num_popped_;
+};
+
+
+/**
+ * \brief Incremental counter of the crossings of a sequence of observations
+ *  with a moving mean.
+ *
+ * A pair of consecutive observations \f$(x_{i-1},x_i)\f$ crosses the mean
+ * \f$m\f$ if \f$m\f$ lies strictly between them, or if both of them are
+ * within \f$\epsilon\f$ of \f$m\f$ (as in AKAROA 2).
+ *
+ * The crossing state of each pair is stored.
+ * When the mean moves from \f$m\f$ to \f$m'\f$, the state of a pair can
+ * only change if one of its observations lies within (about) \f$\epsilon\f$
+ * of the interval between \f$m\f$ and \f$m'\f$; such observations are
+ * found through an ordered index of the observations, and only the pairs
+ * they belong to are re-evaluated.
+ * Since the mean of \f$n\f$ observations moves by \f$O(1/n)\f$ at each new
+ * observation, this costs \f$O(\log n)\f$ amortized time per observation
+ * (instead of rescanning all the pairs), and the resulting count is exactly
+ * the one obtained by rescanning.
+ */
+template <typename RealT>
+class mean_crossing_counter
+{
+	public: typedef RealT real_type;
+	public: typedef ::std::size_t size_type;
+	private: typedef ::std::multimap<real_type,size_type> index_type;
+
+
+	public: explicit mean_crossing_counter(real_type eps = 0)
+	: eps_(eps),
+	  mean_(0),
+	  num_crossings_(0)
+	{
+		// empty
+	}
+
+
+	/**
+	 * \brief Add a new observation and move the mean to \a mean.
+	 * \return The number of pairs of consecutive observations crossing the
+	 *  new mean.
+	 */
+	public: size_type push(real_type value, real_type mean)
+	{
+		const size_type n(values_.size());
+
+		values_.push_back(value);
+		crossings_.push_back(false);
+		index_.insert(::std::make_pair(value, n));
+
+		if (n > 0)
+		{
+			move_mean(mean);
+			update(n, mean);
+		}
+
+		mean_ = mean;
+
+		return num_crossings_;
+	}
+
+
+	/// Return the number of pairs of consecutive observations crossing the mean.
+	public: size_type num_crossings() const
+	{
+		return num_crossings_;
+	}
+
+
+	/// Remove all the observations.
+	public: void clear()
+	{
+		values_.clear();
+		crossings_.clear();
+		index_.clear();
+		mean_ = real_type(0);
+		num_crossings_ = 0;
+	}
+
+
+	/// Tell if the pair (i-1,i) crosses the given mean.
+	private: bool crossing(size_type i, real_type mean) const
+	{
+		const real_type x0(values_[i-1]);
+		const real_type x1(values_[i]);
+
+		return (x0 < mean && mean < x1) // increasing
+			   || (x0 > mean && mean > x1) // decreasing
+			   || ((::std::abs(x0-mean) <= eps_) && (::std::abs(x1-mean) <= eps_)); // equality
+	}
+
+
+	/// Re-evaluate the crossing state of the pair (i-1,i) w.r.t. the given mean.
+	private: void update(size_type i, real_type mean)
+	{
+		const bool cross(crossing(i, mean));
+
+		if (cross != bool(crossings_[i]))
+		{
+			crossings_[i] = cross;
+			if (cross)
+			{
+				++num_crossings_;
+			}
+			else
+			{
+				--num_crossings_;
+			}
+		}
+	}
+
+
+	/// Re-evaluate the pairs whose state may change by moving the mean.
+	private: void move_mean(real_type mean)
+	{
+		const real_type lo(::std::min(mean_, mean));
+		const real_type hi(::std::max(mean_, mean));
+		// Widen the interval to account for the rounding error of |x-mean|
+		const real_type tol(::std::numeric_limits<real_type>::epsilon()*8);
+		const real_type w(eps_*(1+tol) + tol*::std::max(::std::abs(lo), ::std::abs(hi)) + ::std::numeric_limits<real_type>::min());
+
+		const size_type n(values_.size());
+		typename index_type::const_iterator end_it(index_.upper_bound(hi+w));
+		for (typename index_type::const_iterator it = index_.lower_bound(lo-w); it != end_it; ++it)
+		{
+			const size_type i(it->second);
+
+			if (i > 0)
+			{
+				update(i, mean);
+			}
+			if (i+1 < n)
+			{
+				update(i+1, mean);
+			}
+		}
+	}
+
+
+	/// The tolerance used for the equality test.
+	private: real_type eps_;
+	/// The current mean.
+	private: real_type mean_;
+	/// The observations.
+	private: ::std::vector<real_type> values_;
+	/// crossings_[i] tells if the pair (i-1,i) crosses the current mean.
+	private: ::std::vector<bool> crossings_;
+	/// The observations ordered by value.
+	private: index_type index_;
+	/// The number of pairs crossing the current mean.
+	private: size_type num_crossings_;
+};
+
+
 /**
  * \brief Single entry of the look-up table of C1 and C2 values.
  */
@@ -149,13 +463,82 @@ template <typename RealT, typename UIntT>
 }
 
 
+/**
+ * \brief Table of the twiddle factors \f$e^{-2\pi i k/N}\f$,
+ *  \f$k=0,\ldots,N-1\f$, of a discrete Fourier transform of length \f$N\f$.
+ *
+ * The table is only recomputed when the length of the transform changes, so
+ * that it can be reused across several periodogram computations.
+ */
+template <typename RealT>
+class dft_twiddle_table
+{
+	public: typedef RealT real_type;
+	public: typedef ::std::size_t size_type;
+
+
+	/// Make the table suitable for transforms of length \a n.
+	public: void resize(size_type n)
+	{
+		if (n == cos_.size())
+		{
+			return;
+		}
+
+		cos_.resize(n);
+		sin_.resize(n);
+		for (size_type k = 0; k < n; ++k)
+		{
+			const real_type theta = (real_type(2) * ::dcs::math::constants::pi<real_type>::value * k) / real_type(n);
+			cos_[k] = ::std::cos(theta);
+			sin_[k] = ::std::sin(theta);
+		}
+	}
+
+
+	/// Return the length of the transform.
+	public: size_type size() const
+	{
+		return cos_.size();
+	}
+
+
+	/// Return \f$\cos(2\pi k/N)\f$.
+	public: real_type cos(size_type k) const
+	{
+		return cos_[k];
+	}
+
+
+	/// Return \f$\sin(2\pi k/N)\f$.
+	public: real_type sin(size_type k) const
+	{
+		return sin_[k];
+	}
+
+
+	private: ::std::vector<real_type> cos_;
+	private: ::std::vector<real_type> sin_;
+};
+
+
 /**
  * \brief Given observations x[0],...,x[n-1], calculate periodogram
- *  values p[0],...,p[m-1] where p[j-1] = PI(j/n)
+ *  values p[0],...,p[m-1] where p[j-1] = PI(j/n), by using the given table of
+ *  twiddle factors.
+ *
+ * Only the \f$m \ll n\f$ lowest-frequency ordinates are needed, so each of
+ * them is computed by a direct DFT sum whose twiddle factors are taken from
+ * the table (the index of the twiddle factor of the j-th observation for the
+ * n-th ordinate is \f$jn \bmod N\f$), thus avoiding any trigonometric call
+ * inside the loop.
+ * This costs \f$mN\f$ multiply-adds, with no extra error due to the
+ * argument reduction of large angles.
  */
-template <typename Vector1T, typename Vector2T>
+template <typename Vector1T, typename Vector2T, typename RealT>
 void periodogram(::boost::numeric::ublas::vector_expression<Vector1T> const& x,
-				 ::boost::numeric::ublas::vector_container<Vector2T>& p)
+				 ::boost::numeric::ublas::vector_container<Vector2T>& p,
+				 dft_twiddle_table<RealT>& twiddles)
 {
 	namespace ublas = ::boost::numeric::ublas;
 	namespace ublasx = ::boost::numeric::ublasx;
@@ -173,23 +556,66 @@ void periodogram(::boost::numeric::ublas::vector_expression<Vector1T> const& x,
 	size_type x_size = ublasx::size(x);
 	size_type p_size = ublasx::size(p);
 
+	if (x_size == 0)
+	{
+		// No observation: the ordinates are undefined
+		for (size_type n = 0; n < p_size; ++n)
+		{
+			p()(n) = ::std::numeric_limits<real_type>::quiet_NaN();
+		}
+		return;
+	}
+
+	twiddles.resize(x_size);
+
 	for (size_type n = 1; n <= p_size; ++n)
 	{
 		/* Real and imaginary parts of sum */
 		real_type rsum = 0;
 		real_type isum = 0;
 
+		// Note: theta_j = -2*pi*j*n/N, so cos(theta_j) = cos(2*pi*k/N) and
+		//       sin(theta_j) = -sin(2*pi*k/N), with k = j*n mod N
+		const size_type step = n % x_size;
+		size_type k = 0;
 		for (size_type j = 0; j < x_size; ++j)
 		{
-			real_type theta = - (real_type(2) * ::dcs::math::constants::pi<real_type>::value * j * n) / real_type(x_size);
-			rsum += x()(j) * ::std::cos(theta);
-			isum += x()(j) * ::std::sin(theta);
+			const real_type xj = x()(j);
+			rsum += xj * twiddles.cos(k);
+			isum -= xj * twiddles.sin(k);
+
+			k += step;
+			if (k >= x_size)
+			{
+				k -= x_size;
+			}
 		}
 		p()(n-1) = (rsum * rsum + isum * isum) / real_type(x_size);
 	}
 }
 
 
+/**
+ * \brief Given observations x[0],...,x[n-1], calculate periodogram
+ *  values p[0],...,p[m-1] where p[j-1] = PI(j/n)
+ */
+template <typename Vector1T, typename Vector2T>
+void periodogram(::boost::numeric::ublas::vector_expression<Vector1T> const& x,
+				 ::boost::numeric::ublas::vector_container<Vector2T>& p)
+{
+	typedef typename ::boost::numeric::ublas::type_traits<
+				typename ::boost::numeric::ublas::promote_traits<
+					typename ::boost::numeric::ublas::vector_traits<Vector1T>::value_type,
+					typename ::boost::numeric::ublas::vector_traits<Vector2T>::value_type
+				>::promote_type
+			>::real_type real_type;
+
+	dft_twiddle_table<real_type> twiddles;
+
+	periodogram(x, p, twiddles);
+}
+
+
 /**
  * \brief Given periodogram values P[0]..P[2K-1], calculate Lfj[0..K-1] 
  *  where Lfj[j] = L(f_{j+1}) = log((P[2j]+P[2j+1])/2)
@@ -521,6 +947,131 @@ RealT least_squares_poly_at0(::boost::numeric::ublas::vector_expression<Vector1T
 }
 
 
+/**
+ * \brief Precomputed tables for the least-squares polynomial fitting of the
+ *  log-periodogram in the spectral test.
+ *
+ * The abscissae \f$f_j = (4j-1)/(2N)\f$, \f$j=1,\ldots,K\f$, only depend on
+ * the number \f$K\f$ of periodogram points and on the length \f$N\f$ of the
+ * sequence, so the orthonormal polynomial basis evaluated at the abscissae,
+ * and its values and slopes at 0, are computed once (see
+ * least_squares_poly_at0) and recomputed only when \f$K\f$, \f$N\f$ or the
+ * degree change.
+ * Each fit then reduces to \f$k+1\f$ dot products of length \f$K\f$.
+ */
+template <typename RealT>
+class least_squares_poly_table
+{
+	public: typedef RealT real_type;
+	public: typedef ::std::size_t size_type;
+	private: typedef ::boost::numeric::ublas::vector<real_type> vector_type;
+	private: typedef ::boost::numeric::ublas::matrix<real_type> matrix_type;
+
+
+	public: least_squares_poly_table()
+	: num_points_(0),
+	  n_(0),
+	  k_(0)
+	{
+		// empty
+	}
+
+
+	/**
+	 * \brief Make the tables suitable for fitting a polynomial of degree \a k
+	 *  to \a num_points points of the periodogram of a sequence of length
+	 *  \a n.
+	 */
+	public: void resize(size_type num_points, size_type n, size_type k)
+	{
+		if (num_points == num_points_ && n == n_ && k == k_ && phi_.size1() == k+1)
+		{
+			return;
+		}
+
+		vector_type f(num_points);	/* f[j-1] = (4j-1)/(2n) */
+		for (size_type j = 1; j <= num_points; ++j)
+		{
+			f(j-1) = (4*j - 1) / (real_type(2) * n);
+		}
+
+		/* Tables used by orthogonal polynomial routines */
+		vector_type a(k+1);
+		vector_type b(k+1);
+
+		phi_.resize(k+1, num_points, false);
+		phi_0_.resize(k+1, false);
+		dphi_0_.resize(k+1, false);
+
+		orthogonal_polynomial_tables(f, phi_, a, b);
+		orthogonal_polynomial_values(a, b, num_points, real_type(0), phi_0_, dphi_0_);
+
+		num_points_ = num_points;
+		n_ = n;
+		k_ = k;
+	}
+
+
+	/**
+	 * \brief Fit the polynomial to the values \a l at the abscissae and
+	 *  return its value at 0; also return in \a dp0 its slope at 0.
+	 *
+	 * Same as least_squares_poly_at0.
+	 */
+	public: template <typename VectorT>
+		real_type at0(::boost::numeric::ublas::vector_expression<VectorT> const& l, real_type& dp0) const
+	{
+		real_type p0 = 0;
+		dp0 = 0;
+		for (size_type i = 0; i <= k_; ++i)
+		{
+			/* c[i] = l.phi[i] (Note: phi[i].phi[i] = 1) */
+			real_type c = 0;
+			for (size_type j = 0; j < num_points_; ++j)
+			{
+				c += l()(j) * phi_(i,j);
+			}
+
+			p0 += c * phi_0_(i);
+			dp0 += c * dphi_0_(i);
+		}
+
+		return p0;
+	}
+
+
+	/// The number of periodogram points.
+	private: size_type num_points_;
+	/// The length of the sequence.
+	private: size_type n_;
+	/// The degree of the polynomial.
+	private: size_type k_;
+	/// phi[i][j] = phi[i](f[j])
+	private: matrix_type phi_;
+	/// phi_0[i] = phi[i](0)
+	private: vector_type phi_0_;
+	/// dphi_0[i] = phi'[i](0)
+	private: vector_type dphi_0_;
+};
+
+
+/**
+ * \brief Tables reused across the spectral tests performed on sequences of
+ *  the same length.
+ */
+template <typename RealT>
+struct spectral_anova_cache
+{
+	/// The twiddle factors used for computing the periodogram.
+	dft_twiddle_table<RealT> twiddles;
+	/// The least-squares tables for the polynomial of the requested degree.
+	least_squares_poly_table<RealT> fit;
+	/// The least-squares tables for the constant polynomial used by the slope
+	/// protection.
+	least_squares_poly_table<RealT> fit_0;
+};
+
+
 enum slope_protection_category
 {
 	SLOPE_PROTECTION_OFF = 0,
@@ -543,7 +1094,8 @@ bool spectral_anova(::boost::numeric::ublas::vector_expression<VectorT> const& x
 					UIntT delta,
 					slope_protection_category slope_protection,
 					RealT &var,
-					UIntT &kappa)
+					UIntT &kappa,
+					spectral_anova_cache<RealT>& cache)
 {
 	namespace ublas = ::boost::numeric::ublas;
 	namespace ublasx = ::boost::numeric::ublasx;
@@ -563,7 +1115,6 @@ bool spectral_anova(::boost::numeric::ublas::vector_expression<VectorT> const& x
 	//slope_protection_category slope_protection = SLOPE_PROTECTION_OFF;
 	real_type c1;	/* Normalising constant = C1(K,d) */
 	vector_type p(2*num_per_points); /* P[j] = I(j/n) (periodogram values) */
-	vector_type f(num_per_points);	/* f[j-1] = (4j-1)/(2n) */
 	vector_type l(num_per_points);	/* L[j] = log((P[2j-1]+P[2j])/2) */
 
 	::std::pair<real_type,uint_type> c1_k;
@@ -574,18 +1125,14 @@ bool spectral_anova(::boost::numeric::ublas::vector_expression<VectorT> const& x
 	c1 = c1_k.first;
 	kappa = c1_k.second;
 
-	periodogram(x, p);
+	periodogram(x, p, cache.twiddles);
 
 	size_type N = ublasx::size(x);
 
-	for (uint_type j = 1; j <= num_per_points; ++j)
-	{
-		f(j-1) = (4*j - 1) / (real_type(2) * N);
-	}
-
 	log_average_pairs_and_offset(p, l, real_type(0.270));
+	cache.fit.resize(num_per_points, N, delta);
 	real_type da0;
-	real_type a0 = least_squares_poly_at0(f, l, delta, da0);
+	real_type a0 = cache.fit.at0(l, da0);
 	real_type px0 = c1 * ::std::exp(a0);
 	var = px0 / real_type(N);
 
@@ -602,7 +1149,8 @@ bool spectral_anova(::boost::numeric::ublas::vector_expression<VectorT> const& x
 			c1_k = lookup_periodogram_delta<real_type>(num_per_points, delta);
 			c1 = c1_k.first;
 			kappa_2 = c1_k.second;
-			a0 = least_squares_poly_at0(f, l, delta, da0);
+			cache.fit_0.resize(num_per_points, N, delta);
+			a0 = cache.fit_0.at0(l, da0);
 			px0 = c1 * ::std::exp(a0);
 			real_type var_2 = px0 / real_type(N);
 
@@ -647,6 +1195,26 @@ bool spectral_anova(::boost::numeric::ublas::vector_expression<VectorT> const& x
 	return slope_corrected;
 }
 
+
+/**
+ * \brief Estimate the variance of a sequence of observations and return the
+ *  number of degrees of freedom.
+ *
+ * Same as above, but with temporary tables.
+ */
+template <typename VectorT, typename UIntT, typename RealT>
+bool spectral_anova(::boost::numeric::ublas::vector_expression<VectorT> const& x,
+					UIntT num_per_points,
+					UIntT delta,
+					slope_protection_category slope_protection,
+					RealT &var,
+					UIntT &kappa)
+{
+	spectral_anova_cache<RealT> cache;
+
+	return spectral_anova(x, num_per_points, delta, slope_protection, var, kappa, cache);
+}
+
 }} // Namespace detail::<unnamed>
 
 
@@ -675,8 +1243,9 @@ class pawlikowski1990_transient_detector
 	public: typedef UIntT uint_type;
 	public: typedef ::std::size_t size_type;
 	public: typedef ::std::pair<real_type,real_type> sample_type;
-	public: typedef ::std::vector<sample_type> sample_container;
+	public: typedef sample_range<real_type> sample_range_type;
 	private: typedef ::boost::numeric::ublas::vector<real_type> vector_type;
+	private: typedef ::dcs::des::detail::ring_buffer<real_type,vector_type> buffer_type;
 
 
 	/// Constant for setting the duration of batch size determination
@@ -746,9 +1315,8 @@ class pawlikowski1990_transient_detector
 		  n0_(0),
 		  n0_max_(n0_max),
 		  max_heuristic_len_(default_max_heuristic_length),
-		  obs_(n_v),
-		  weights_(n_v),
-		  num_buf_obs_(0),
+		  obs_(),
+		  weights_(),
 		  gamma_(gamma),
 		  gamma_v_(gamma_v),
 		  alpha_t_(alpha_t),
@@ -761,7 +1329,10 @@ class pawlikowski1990_transient_detector
 		  n_ap_(n_ap),
 		  delta_(delta),
 		  slope_protection_(default_slope_protection),
-		  eps_(eps)
+		  eps_(eps),
+		  anova_cache_(),
+		  crossings_(eps),
+		  schruben_()
 	{
 		// post-conditions
 		DCS_ASSERT(
@@ -809,7 +1380,7 @@ class pawlikowski1990_transient_detector
 		{
 			// Transient phase not detected but reached maximum check length
 
-			DCS_DEBUG_TRACE("Failed to detect transient phase after " << num_buf_obs_ << " observations: maximum allowed transient phase length reached.");
+			DCS_DEBUG_TRACE("Failed to detect transient phase after " << num_obs_ << " observations: maximum allowed transient phase length reached.");
 
 			detect_aborted_ = true;
 			detected_trans_ = false;
@@ -818,23 +1389,13 @@ class pawlikowski1990_transient_detector
 
 		++num_obs_;
 
-		// Buffer this observation
-		if (num_buf_obs_ == obs_.size())
-		{
-			// enlarge the observations vector
-			obs_.resize(obs_.size() * 1.5);
-			//obs_.resize(obs_.size() * 2);
-			weights_.resize(weights_.size() * 1.5);
-		}
-		obs_[num_buf_obs_] = value;
-		weights_[num_buf_obs_] = weight;
-		++num_buf_obs_;
-
 		//if (n0_ == 0)
 		if (n0_star_ == 0)
 		{
 			// STEP 1: find a first approximation of the transient length by
 			// applying a specific heuristic
+			// Note: the observations seen by the heuristic are not used by
+			// the next steps, so they don't need to be buffered.
 
 			// Still in transient
 			heuristic_phase(value);
@@ -842,8 +1403,14 @@ class pawlikowski1990_transient_detector
 			return false;
 		}
 
+		// Buffer this observation
+		obs_.push_back(value);
+		weights_.push_back(weight);
+
 		if (safe_num_obs_ == 0)
 		{
+			schruben_.push(value);
+
 			schruben_phase();
 
 			if (!detected_trans_)
@@ -960,8 +1527,8 @@ class pawlikowski1990_transient_detector
 		detect_aborted_ = detected_trans_
 						= false;
 
-		num_obs_ = n0_
-				 = num_buf_obs_
+		num_obs_ = n0_star_
+				 = n0_
 				 = n_t_
 				 = gamma_n0_star_
 				 //= delta_n_
@@ -970,31 +1537,26 @@ class pawlikowski1990_transient_detector
 
 		sum_ = real_type(0);
 
-		//obs_.resize(initial_buf_size, false);
-		obs_.resize(n_v_, false);
-		weights_.resize(n_v_, false);
+		crossings_.clear();
+		schruben_.reset();
+
+		// Release the buffers (they are sized at the end of the heuristic
+		// phase)
+		obs_.reset(0);
+		weights_.reset(0);
 	}
 
 
 	/**
 	 * \brief Return the steady-state observations possibly used during
 	 *  transient phase detection.
-	 * \return The steady-state observations possibly used during transient
-	 *  phase detection.
+	 * \return A view of the steady-state observations possibly used during
+	 *  transient phase detection, which is valid until the next call to
+	 *  \c detect or \c reset.
 	 */
-	public: sample_container steady_state_observations() const
+	public: sample_range_type steady_state_observations() const
 	{
-		const size_type n(obs_.size());
-
-		sample_container samples(n);
-
-		for (size_type i = 0; i < n; ++i)
-		{
-			samples[i] = ::std::make_pair(obs_(i), weights_(i));
-		}
-
-		//return obs_;
-		return samples;
+		return sample_range_type(obs_.data(), weights_.data(), obs_.size());
 	}
 
 
@@ -1015,9 +1577,9 @@ class pawlikowski1990_transient_detector
 	 */
 	private: void heuristic_phase(real_type value)
 	{
-		if (max_heuristic_len_ != num_obs_infinity && num_buf_obs_ > max_heuristic_len_)
+		if (max_heuristic_len_ != num_obs_infinity && num_obs_ > max_heuristic_len_)
 		{
-			DCS_DEBUG_TRACE("Failed to leave heuristic phase of Schruben test after " << num_buf_obs_ << " observations: maximum heuristic phase length reached.");
+			DCS_DEBUG_TRACE("Failed to leave heuristic phase of Schruben test after " << num_obs_ << " observations: maximum heuristic phase length reached.");
 			//throw ::std::runtime_error("Maximum heuristic phase length of Schruben test reached.");
 			detect_aborted_ = true;
 			detected_trans_ = false;
@@ -1028,25 +1590,11 @@ class pawlikowski1990_transient_detector
 
 		sum_ += value;
 		real_type mean = sum_/real_type(num_obs_);
-		uint_type num_crossings = 0;
-		//for (size_type i = 1; i < num_buf_obs_ && num_crossings < min_num_mean_crossings_; ++i)
-		for (size_type i = 1; i < num_obs_ && num_crossings < min_num_mean_crossings_; ++i)
-		{
-			//if (
-			//	(((obs_[i-1]-mean) <= eps_) && ((mean-obs_[i]) <= eps_))
-			//	|| (((mean-obs_[i-1]) <= eps_) && ((obs_[i]-mean) <= eps_))
-			//)
-			// This is used in AKAROA 2
-			if (
-				(obs_[i-1] < mean && mean < obs_[i]) // increasing
-				|| (obs_[i-1] > mean && mean > obs_[i]) // decreasing
-				|| ((::std::abs(obs_[i-1]-mean) <= eps_) && (::std::abs(obs_[i]-mean) <= eps_)) // equality
-			) {
-				// cross found
-				++num_crossings;
-			}
-		}
-		if (num_crossings == min_num_mean_crossings_)
+		// Count the crossings of the new mean, by only re-checking the pairs
+		// of observations near the old and the new mean (see
+		// detail::mean_crossing_counter).
+		const size_type num_crossings = crossings_.push(value, mean);
+		if (num_crossings >= min_num_mean_crossings_)
 		{
 			// Heuristic phase has finished
 
@@ -1058,11 +1606,11 @@ class pawlikowski1990_transient_detector
 			n_t_ = ::std::max(gamma_n0_star_, uint_type(gamma_v_ * n_v_));
 			//delta_n_ = n_t_;
 			// clear and resize the buffer
-			obs_.resize(n_t_, false);
-			weights_.resize(n_t_, false);
-			//obs_.clear();
-			num_buf_obs_ = 0;
-			//obs_ = ::std::vector(n_t_);
+			obs_.reset(n_t_);
+			weights_.reset(n_t_);
+			crossings_.clear();
+			// Center the tested observations on the current mean
+			schruben_.reset(mean);
 
 			DCS_DEBUG_TRACE("Initial approximation of transient length " << n0_star_ << " (n_t: " << n_t_ << ")");
 		}
@@ -1072,70 +1620,53 @@ class pawlikowski1990_transient_detector
 	{
 		// STEP 2
 
-		if (num_buf_obs_ == n_t_)
+		if (obs_.full())
 		{
 			// STEP 3
 
-			DCS_DEBUG_TRACE("Performing Schruben test on " << num_buf_obs_ << " observations");
+			DCS_DEBUG_TRACE("Performing Schruben test on " << obs_.size() << " observations");
+
+			// The buffered observations are contiguous in the storage of the
+			// ring buffer, starting from its offset
+			const size_type off(obs_.offset());
 
 			real_type variance;
 			uint_type kappa;
 
 			// Estimates the variance
 			detail::spectral_anova(
-				::boost::numeric::ublas::subrange(obs_, num_buf_obs_-n_v_, num_buf_obs_),
+				::boost::numeric::ublas::subrange(obs_.storage(), off+n_t_-n_v_, off+n_t_),
 				n_ap_,
 				delta_,
 				slope_protection_,
 				variance,
-				kappa
+				kappa,
+				anova_cache_
 			);
 
-			// Computes Schruben statistic
-			real_type schruben_stat = ::std::abs(
-				detail::schruben_statistic(
-					::boost::numeric::ublas::subrange(obs_, 0, n_t_),
-					n_v_,
-					variance
-				)
-			);
+			// Computes Schruben statistic (the window sums are maintained
+			// incrementally, see detail::schruben_statistic_accumulator)
+			real_type schruben_stat = ::std::abs(schruben_.value(n_v_, variance));
 
 			// Performs the hypothesis testing
-			::dcs::math::stats::students_t_distribution<real_type> t_dist(kappa);
-			real_type t = t_dist.quantile(real_type(1) - alpha_t_/real_type(2));
+			real_type t = ::dcs::des::detail::students_t_quantile(kappa, real_type(1) - alpha_t_/real_type(2));
 			if (schruben_stat <= t)
 			{
 				// Out of transient
 
 				DCS_DEBUG_TRACE("The initial transient period is no longer than " << n0_ << " observations.");
 
-				detected_trans_ = true;
-
-				// The observation vector now contains only steady-state
+				// The observation buffer now contains only steady-state
 				// observations
-				obs_.resize(num_buf_obs_, true);
-				weights_.resize(num_buf_obs_, true);
+				detected_trans_ = true;
 			}
 			else
 			{
-//				for (::std::size_t i = 0; i < num_buf_obs_; ++i)
-//				{
-//					obs_[i] = obs_[i + gamma_n0_star_];
-//				}
-//				obs_.resize(obs_.size() - gamma_n0_star_);
-
-				::std::copy(
-						obs_.begin() + gamma_n0_star_,
-						obs_.begin() + num_buf_obs_,
-						obs_.begin()
-					);
-				::std::copy(
-						weights_.begin() + gamma_n0_star_,
-						weights_.begin() + num_buf_obs_,
-						weights_.begin()
-					);
-
-				num_buf_obs_ -= gamma_n0_star_;
+				// Slide the tested sequence
+				schruben_.pop_front(obs_.data(), gamma_n0_star_);
+				obs_.pop_front(gamma_n0_star_);
+				weights_.pop_front(gamma_n0_star_);
+
 				n0_ += gamma_n0_star_;
 			}
 		}
@@ -1167,17 +1698,11 @@ class pawlikowski1990_transient_detector
 	/// Maximum allowed number of observations during the heuristic phase.
 	private: /*const*/ uint_type max_heuristic_len_;
 
-	/* Used during both phases: */
-	/// Vector holding recent observations.
-	private: vector_type obs_;
-	/// Vector holding recent observation weights.
-	private: vector_type weights_;
-//	/// Size of the buffer.
-//	private: size_type buf_size_;
-	/// Number of observations inserted in the buffer.
-	private: uint_type num_buf_obs_;
-
 	/* Used during Schruben testing phase: */
+	/// Buffer holding the sequence of observations to test.
+	private: buffer_type obs_;
+	/// Buffer holding the weights of the sequence of observations to test.
+	private: buffer_type weights_;
 	/// Exchange factor for calculating step size between tests.
 	private: /*const*/ real_type gamma_;
 	/// Safety factor for variance estimation sequential length.
@@ -1205,6 +1730,13 @@ class pawlikowski1990_transient_detector
 	private: /*const*/ detail::slope_protection_category slope_protection_;
 	/// Tolerance for floating-point equality test.
 	private: /*const*/ real_type eps_;
+	/// The tables used by the spectral test (they only depend on n_v, n_ap
+	/// and delta, so they are computed once).
+	private: detail::spectral_anova_cache<real_type> anova_cache_;
+	/// The counter of mean crossings used during the heuristic phase.
+	private: detail::mean_crossing_counter<real_type> crossings_;
+	/// The incremental Schruben statistic of the tested sequence.
+	private: detail::schruben_statistic_accumulator<real_type> schruben_;
 }; // pawlikowski1990_transient_detector
 
 template <typename RealT, typename UIntT>
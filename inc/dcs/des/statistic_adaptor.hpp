@@ -29,6 +29,7 @@
 #define DCS_DES_STATISTIC_ADAPTOR_HPP
 
 
+#include <cstddef>
 #include <dcs/des/base_statistic.hpp>
 #include <dcs/des/statistic_categories.hpp>
 #include <dcs/type_traits/add_const.hpp>
@@ -82,6 +83,17 @@ class statistic_adaptor: public base_statistic<
 	}
 
 
+    private: void do_collect_block(value_type const* obs, value_type const* weights, ::std::size_t n)
+	{
+		// Note: the adaptee is not required to provide a block collection
+		//       function
+		for (::std::size_t i = 0; i < n; ++i)
+		{
+			adaptee_(obs[i], weights ? weights[i] : value_type(1));
+		}
+	}
+
+
     private: void do_reset()
 	{
 		adaptee_.reset();
@@ -31,10 +31,9 @@
 
 #include <algorithm>
 #include <cmath>
+#include <dcs/des/detail/quantile_cache.hpp>
 #include <dcs/iterator/any_forward_iterator.hpp>
 #include <dcs/iterator/iterator_range.hpp>
-#include <dcs/math/stats/distribution/normal.hpp>
-#include <dcs/math/stats/distribution/students_t.hpp>
 #include <limits>
 
 
@@ -87,9 +86,7 @@ UIntT num_replications(RealT, ::dcs::iterator::iterator_range< ::dcs::iterator::
 template <typename RealT, typename UIntT>
 UIntT num_replications_initial(RealT eps, RealT s0, RealT level=0.95)
 {
-	::dcs::math::stats::normal_distribution<RealT> dist;
-
-	RealT z = dist.quantile((1+level)/RealT(2));
+	RealT z = detail::normal_quantile((1+level)/RealT(2));
 	RealT r0 = z*s0/eps;
 	return static_cast<UIntT>(::std::ceil(r0*r0));
 }
@@ -124,8 +121,6 @@ UIntT num_replications_initial(RealT eps, RealT s0, RealT level=0.95)
 template <typename RealT, typename UIntT>
 UIntT num_replications_initial(RealT eps, ::dcs::iterator::iterator_range< ::dcs::iterator::any_forward_iterator<RealT> > const& s0_range, RealT level=0.95)
 {
-	::dcs::math::stats::normal_distribution<RealT> dist;
-
 	UIntT r_max(0);
 
 	for (
@@ -170,6 +165,8 @@ UIntT num_replications_initial(RealT eps, ::dcs::iterator::iterator_range< ::dcs
  *   output statistics.
  * - \f$\epsilon\f$ is the precision given by \a eps.
  * .
+ * Since the right-hand side decreases with \f$R\f$, the smallest \f$R\f$
+ * is found by a bisection search (see detail::students_t_sample_size).
  */
 template <typename RealT, typename UIntT>
 UIntT num_replications(RealT eps, UIntT r0, RealT s0, RealT level=0.95, UIntT max_trials=::std::numeric_limits<UIntT>::max())
@@ -179,22 +176,9 @@ UIntT num_replications(RealT eps, UIntT r0, RealT s0, RealT level=0.95, UIntT ma
 		return r0;
 	}
 
-	RealT r(0);
-	UIntT trial(0);
-
-	while (r0 < r && trial < max_trials)
-	{
-		::dcs::math::stats::students_t_distribution<RealT> dist(r0-1);
-
-		RealT t = dist.quantile((1+level)/RealT(2));
-		r = t*s0/eps;
-		r *= r;
-
-		++trial;
-		++r0;
-	}
+	const UIntT r_max((max_trials < ::std::numeric_limits<UIntT>::max()-r0) ? r0+max_trials : ::std::numeric_limits<UIntT>::max());
 
-	return r0;
+	return detail::students_t_sample_size(s0/eps, (1+level)/RealT(2), r0, r_max);
 }
 
 
@@ -247,24 +231,7 @@ UIntT num_replications(RealT eps, UIntT r0, ::dcs::iterator::iterator_range< ::d
 		it != s0_range.end();
 		++it
 	) {
-		RealT r(0);
-		UIntT trial(0);
-
-		do
-		{
-			++r0;
-
-			::dcs::math::stats::students_t_distribution<RealT> dist(r0-1);
-
-			RealT t = dist.quantile((1+level)/RealT(2));
-			r = t*(*it)/eps;
-			r *= r;
-
-			++trial;
-		}
-		while (r0 < r && trial < max_trials);
-
-		r_max = ::std::max(r0, r_max);
+		r_max = ::std::max(num_replications(eps, r0, *it, level, max_trials), r_max);
 	}
 
 	return r_max;
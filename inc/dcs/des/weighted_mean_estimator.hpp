@@ -30,13 +30,14 @@
 
 
 #include <cmath>
+#include <cstddef>
 #include <cstdlib>
 #include <dcs/debug.hpp>
 #include <dcs/des/base_statistic.hpp>
+#include <dcs/des/detail/block_moments.hpp>
+#include <dcs/des/detail/quantile_cache.hpp>
 #include <dcs/des/statistic_categories.hpp>
 #include <dcs/math/constants.hpp>
-#include <dcs/math/stats/distribution/students_t.hpp>
-#include <dcs/math/stats/function/quantile.hpp>
 #include <dcs/math/function/sqr.hpp>
 #include <iostream>
 #include <string>
@@ -117,6 +118,33 @@ class weighted_mean_estimator: public base_statistic<ValueT,UIntT>
 	}
 
 
+	private: void do_collect_block(value_type const* obs, value_type const* weights, ::std::size_t n)
+	{
+		if (n == 0)
+		{
+			return;
+		}
+
+		// Compute the moments of the block and merge them with the current
+		// ones
+		value_type sumw;
+		value_type m;
+		value_type s2;
+		if (weights)
+		{
+			detail::weighted_block_moments(obs, weights, n, sumw, m, s2);
+		}
+		else
+		{
+			detail::block_moments(obs, n, m, s2);
+			sumw = value_type(n);
+		}
+
+		detail::merge_moments(sumw_, m_, s2_, sumw, m, s2);
+		count_ += n;
+	}
+
+
 	private: value_type do_estimate() const
 	{
 		return m_;
@@ -127,8 +155,7 @@ class weighted_mean_estimator: public base_statistic<ValueT,UIntT>
 	{
 		if (count_ > 1)
 		{
-			::dcs::math::stats::students_t_distribution<value_type> t_dist(count_-1);
-			value_type t = ::dcs::math::stats::quantile(t_dist, (value_type(1)+this->confidence_level())/value_type(2));
+			value_type t = detail::students_t_quantile(count_-1, (value_type(1)+this->confidence_level())/value_type(2));
 
 			//return ::std::sqrt(this->variance()/count_)*t;
 			return t*(this->standard_deviation()/::std::sqrt(count_));